@@ -0,0 +1,298 @@
+#include "History/SceneHistoryManager.h"
+#include "MeshSceneSubsystem.h"
+#include "ToolsSubsystem.h"
+#include "Interaction/SceneObject.h"
+#include "Components/BaseDynamicMeshComponent.h"
+#include "Changes/MeshReplacementChange.h"
+#include "Generators/SphereGenerator.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/StrongObjectPtr.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace UE::Geometry;
+
+#define LOCTEXT_NAMESPACE "SceneHistoryBenchmark"
+
+
+namespace RuntimeToolsHistoryBenchmark {
+
+constexpr int32 NumObjects = 64;
+constexpr int32 NumTransactions = 5000;
+constexpr int32 MeshResolution = 16;
+constexpr int32 Seed = 31337;
+
+struct FLatencySamples {
+    TArray<double> Milliseconds;
+
+    void Add(double StartSeconds) {
+        Milliseconds.Add((FPlatformTime::Seconds() - StartSeconds) * 1000.0);
+    }
+
+    double Percentile(double P) const {
+        const int32 Index = FMath::Clamp(FMath::CeilToInt(P * Milliseconds.Num()) - 1, 0, Milliseconds.Num() - 1);
+        return Milliseconds[Index];
+    }
+
+    void Report(const TCHAR* Name) {
+        if (Milliseconds.Num() == 0) {
+            return;
+        }
+        Milliseconds.Sort();
+
+        double Total = 0;
+        for (double Value : Milliseconds) {
+            Total += Value;
+        }
+
+        UE_LOG(
+            LogTemp, Display,
+            TEXT("[HistoryBenchmark] %-8s n=%6d total=%9.2fms p50=%8.4fms p90=%8.4fms p99=%8.4fms max=%8.4fms"), Name,
+            Milliseconds.Num(), Total, Percentile(0.5), Percentile(0.9), Percentile(0.99), Milliseconds.Last()
+        );
+    }
+};
+
+
+// used physical memory relative to Baseline
+static double MemoryDeltaMiB(const FPlatformMemoryStats& Baseline) {
+    const int64 Delta =
+        static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - static_cast<int64>(Baseline.UsedPhysical);
+    return static_cast<double>(Delta) / (1024.0 * 1024.0);
+}
+
+
+// per-SceneObject state tracked by the benchmark, so that it can generate valid changes and check the sweeps
+struct FBenchmarkObject {
+    USceneObject* SceneObject = nullptr;
+    UBaseDynamicMeshComponent* Component = nullptr;
+    TSharedPtr<const FDynamicMesh3> InitialMesh;
+    TSharedPtr<const FDynamicMesh3> CurrentMesh;
+    bool bInScene = true;
+};
+
+}  // namespace RuntimeToolsHistoryBenchmark
+
+
+/**
+ * RuntimeTools.History.UndoRedoBenchmark
+ *
+ * Creates a scene of SceneObjects through the UMeshSceneSubsystem, records mixed transactions (add/remove, selection
+ * and mesh replacement changes on the SceneObject mesh components) into a private USceneHistoryManager, and then times
+ * a full Undo() sweep followed by a full Redo() sweep. Per-operation latency percentiles and the used memory relative
+ * to the start of the test are written to the log, and the scene is checked against its recorded state after each
+ * sweep.
+ *
+ * Needs a running game with the tools subsystems. Creating and deleting the SceneObjects goes through the
+ * UMeshSceneSubsystem, and so is recorded in the tools history like any other edit.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+    FSceneHistoryUndoRedoBenchmark, "RuntimeTools.History.UndoRedoBenchmark",
+    EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter
+)
+
+bool FSceneHistoryUndoRedoBenchmark::RunTest(const FString& Parameters) {
+    using namespace RuntimeToolsHistoryBenchmark;
+
+    UToolsSubsystem* ToolsSubsystem = UToolsSubsystem::TryGet();
+    UMeshSceneSubsystem* SceneSubsystem = UMeshSceneSubsystem::Get();
+    if (ToolsSubsystem == nullptr || ToolsSubsystem->TargetWorld == nullptr || SceneSubsystem == nullptr) {
+        AddError(TEXT("requires a running game with an initialized UToolsSubsystem and UMeshSceneSubsystem"));
+        return false;
+    }
+
+    FRandomStream Random(Seed);
+    const FPlatformMemoryStats BaselineMemory = FPlatformMemory::GetStats();
+
+    //
+    // build the scene
+    //
+
+    FSphereGenerator SphereGen;
+    SphereGen.Radius = 50.0;
+    SphereGen.NumPhi = MeshResolution;
+    SphereGen.NumTheta = MeshResolution;
+    SphereGen.Generate();
+    const FDynamicMesh3 BaseMesh(&SphereGen);
+
+    const TArray<USceneObject*> InitialSelection = SceneSubsystem->GetSelection();
+
+    TArray<FBenchmarkObject> Objects;
+    Objects.Reserve(NumObjects);
+
+    auto DeleteObjects = [&]() {
+        SceneSubsystem->SetSelection(InitialSelection);
+        for (FBenchmarkObject& Object : Objects) {
+            if (Object.bInScene == false) {
+                // add it back first, so that it is deleted (and can be restored) like any other SceneObject
+                FAddRemoveSceneObjectChange AddChange;
+                AddChange.SceneObject = Object.SceneObject;
+                AddChange.bAdded = true;
+                AddChange.Apply(Object.SceneObject);
+            }
+            SceneSubsystem->DeleteSceneObject(Object.SceneObject);
+        }
+    };
+
+    for (int32 k = 0; k < NumObjects; ++k) {
+        FBenchmarkObject& Object = Objects.AddDefaulted_GetRef();
+        Object.SceneObject = SceneSubsystem->CreateNewSceneObject();
+        Object.SceneObject->Initialize(ToolsSubsystem->TargetWorld, &BaseMesh);
+        Object.SceneObject->SetTransform(FTransform(FVector(150.0 * (k % 32), 150.0 * (k / 32), 0)));
+
+        Object.Component = Cast<UBaseDynamicMeshComponent>(Object.SceneObject->GetMeshComponent());
+        if (Object.Component == nullptr || Object.Component->GetMesh() == nullptr) {
+            AddError(TEXT("SceneObject has no dynamic mesh component to record mesh replacement changes on"));
+            DeleteObjects();
+            return false;
+        }
+        Object.InitialMesh = MakeShared<const FDynamicMesh3>(*Object.Component->GetMesh());
+        Object.CurrentMesh = Object.InitialMesh;
+    }
+
+    const double SceneMemory = MemoryDeltaMiB(BaselineMemory);
+
+    //
+    // record mixed transactions
+    //
+
+    TStrongObjectPtr<USceneHistoryManager> History(NewObject<USceneHistoryManager>());
+    History->bLogChanges = false;
+    TArray<USceneObject*> CurrentSelection = InitialSelection;
+    FLatencySamples RecordSamples, UndoSamples, RedoSamples;
+    int32 NumAddRemove = 0, NumSelection = 0, NumMeshReplace = 0;
+
+    for (int32 TransactionIndex = 0; TransactionIndex < NumTransactions; ++TransactionIndex) {
+        FBenchmarkObject& Object = Objects[Random.RandHelper(NumObjects)];
+        const int32 ChangeType = Random.RandHelper(3);
+
+        TUniquePtr<FToolCommandChange> Change;
+        UObject* ChangeTarget = nullptr;
+
+        if (ChangeType == 0) {
+            // never remove a selected object, the selection change would not be recorded in this transaction
+            if (CurrentSelection.Contains(Object.SceneObject)) {
+                continue;
+            }
+            TUniquePtr<FAddRemoveSceneObjectChange> AddRemoveChange = MakeUnique<FAddRemoveSceneObjectChange>();
+            AddRemoveChange->SceneObject = Object.SceneObject;
+            AddRemoveChange->bAdded = !Object.bInScene;
+            AddRemoveChange->Apply(Object.SceneObject);
+            Object.bInScene = !Object.bInScene;
+            ChangeTarget = Object.SceneObject;
+            Change = MoveTemp(AddRemoveChange);
+            NumAddRemove++;
+        } else if (ChangeType == 1) {
+            TUniquePtr<FMeshSceneSelectionChange> SelectionChange = MakeUnique<FMeshSceneSelectionChange>();
+            SelectionChange->OldSelection = CurrentSelection;
+            const int32 NumSelected = Random.RandRange(0, FMath::Min(4, NumObjects));
+            for (int32 k = 0; k < NumSelected; ++k) {
+                FBenchmarkObject& Selected = Objects[Random.RandHelper(NumObjects)];
+                if (Selected.bInScene) {
+                    SelectionChange->NewSelection.AddUnique(Selected.SceneObject);
+                }
+            }
+            SelectionChange->Apply(SceneSubsystem);
+            CurrentSelection = SelectionChange->NewSelection;
+            ChangeTarget = SceneSubsystem;
+            Change = MoveTemp(SelectionChange);
+            NumSelection++;
+        } else {
+            TSharedPtr<FDynamicMesh3> NewMesh = MakeShared<FDynamicMesh3>(*Object.CurrentMesh);
+            const FVector3d Offset(Random.FRandRange(-1, 1), Random.FRandRange(-1, 1), Random.FRandRange(-1, 1));
+            for (int32 VertexID : NewMesh->VertexIndicesItr()) {
+                NewMesh->SetVertex(VertexID, NewMesh->GetVertex(VertexID) + Offset);
+            }
+            TUniquePtr<FMeshReplacementChange> ReplaceChange =
+                MakeUnique<FMeshReplacementChange>(Object.CurrentMesh, NewMesh);
+            ReplaceChange->Apply(Object.Component);
+            Object.CurrentMesh = NewMesh;
+            ChangeTarget = Object.Component;
+            Change = MoveTemp(ReplaceChange);
+            NumMeshReplace++;
+        }
+
+        const double StartTime = FPlatformTime::Seconds();
+        History->BeginTransaction(LOCTEXT("BenchmarkTransaction", "Benchmark"));
+        History->AppendChange(ChangeTarget, MoveTemp(Change), LOCTEXT("BenchmarkChange", "Benchmark Change"));
+        History->EndTransaction();
+        RecordSamples.Add(StartTime);
+    }
+
+    const double RecordedMemory = MemoryDeltaMiB(BaselineMemory);
+
+    // @return true if every object is in the scene as expected, with the first vertex of the expected mesh
+    auto CheckScene = [&](bool bUndone) {
+        for (const FBenchmarkObject& Object : Objects) {
+            const bool bInScene = SceneSubsystem->FindSceneObjectByActor(Object.SceneObject->GetActor()) != nullptr;
+            const FDynamicMesh3& Expected = bUndone ? *Object.InitialMesh : *Object.CurrentMesh;
+            const int32 VertexID = *Expected.VertexIndicesItr().begin();
+            const FDynamicMesh3* Mesh = Object.Component->GetMesh();
+            if (bInScene != (bUndone || Object.bInScene) || Mesh->IsVertex(VertexID) == false ||
+                FVector3d::DistSquared(Mesh->GetVertex(VertexID), Expected.GetVertex(VertexID)) > 1e-12) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    //
+    // undo/redo sweeps
+    //
+
+    for (int32 k = 0; k < RecordSamples.Milliseconds.Num(); ++k) {
+        const double StartTime = FPlatformTime::Seconds();
+        History->Undo();
+        UndoSamples.Add(StartTime);
+    }
+    TestTrue(TEXT("Undo() sweep restores the initial scene"), CheckScene(true));
+    TestTrue(TEXT("Undo() sweep restores the initial selection"), SceneSubsystem->GetSelection() == InitialSelection);
+
+    for (int32 k = 0; k < RecordSamples.Milliseconds.Num(); ++k) {
+        const double StartTime = FPlatformTime::Seconds();
+        History->Redo();
+        RedoSamples.Add(StartTime);
+    }
+    TestTrue(TEXT("Redo() sweep restores the recorded scene"), CheckScene(false));
+    TestTrue(TEXT("Redo() sweep restores the recorded selection"), SceneSubsystem->GetSelection() == CurrentSelection);
+
+    const double SweepMemory = MemoryDeltaMiB(BaselineMemory);
+
+    //
+    // report
+    //
+
+    UE_LOG(
+        LogTemp, Display,
+        TEXT("[HistoryBenchmark] objects=%d triangles/object=%d transactions=%d (add/remove=%d selection=%d "
+             "mesh=%d) seed=%d"),
+        NumObjects, BaseMesh.TriangleCount(), RecordSamples.Milliseconds.Num(), NumAddRemove, NumSelection,
+        NumMeshReplace, Seed
+    );
+    RecordSamples.Report(TEXT("Record"));
+    UndoSamples.Report(TEXT("Undo"));
+    RedoSamples.Report(TEXT("Redo"));
+    UE_LOG(
+        LogTemp, Display,
+        TEXT("[HistoryBenchmark] memory used since start: %+.1fMiB with the scene, %+.1fMiB after recording, "
+             "%+.1fMiB after sweeps"),
+        SceneMemory, RecordedMemory, SweepMemory
+    );
+
+    //
+    // cleanup
+    //
+
+    History.Reset();
+    DeleteObjects();
+
+    return true;
+}
+
+
+#undef LOCTEXT_NAMESPACE
+
+#endif  // WITH_DEV_AUTOMATION_TESTS
@@ -1,4 +1,9 @@
 #include "History/SceneHistoryManager.h"
+#include "RuntimeToolsStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("History AppendChange"), STAT_RuntimeTools_HistoryAppendChange, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("History Undo"), STAT_RuntimeTools_HistoryUndo, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("History Redo"), STAT_RuntimeTools_HistoryRedo, STATGROUP_RuntimeTools);
 
 
 bool FChangeHistoryTransaction::HasExpired() const {
@@ -58,6 +63,8 @@ void USceneHistoryManager::TruncateHistory() {
 void USceneHistoryManager::AppendChange(
     UObject* TargetObject, TUniquePtr<FCommandChange> Change, const FText& Description
 ) {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_HistoryAppendChange);
+
     bool bAutoCloseTransaction = false;
     if (ensure(BeginTransactionDepth > 0) == false) {
         BeginTransaction(Description);
@@ -70,7 +77,9 @@ void USceneHistoryManager::AppendChange(
     Record.ChangeWrapper = MakeShared<FChangeHistoryRecord::FChangeWrapper>();
     Record.ChangeWrapper->Change = MoveTemp(Change);
 
-    UE_LOG(LogTemp, Warning, TEXT("[HISTORY] %s"), *Record.Description.ToString());
+    if (bLogChanges) {
+        UE_LOG(LogTemp, Warning, TEXT("[HISTORY] %s"), *Record.Description.ToString());
+    }
 
     ActiveTransaction.Records.Add(MoveTemp(Record));
 
@@ -82,10 +91,14 @@ void USceneHistoryManager::AppendChange(
 
 
 void USceneHistoryManager::Undo() {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_HistoryUndo);
+
     int32 NumReverted = 0;
     while (CurrentIndex > 0) {
         CurrentIndex = CurrentIndex - 1;
-        UE_LOG(LogTemp, Warning, TEXT("[UNDO] %s"), *Transactions[CurrentIndex].Description.ToString());
+        if (bLogChanges) {
+            UE_LOG(LogTemp, Warning, TEXT("[UNDO] %s"), *Transactions[CurrentIndex].Description.ToString());
+        }
 
         // if transaction has expired, it is effectively a no-op and so we will continue to Undo()
         bool bContinue = Transactions[CurrentIndex].HasExpired();
@@ -109,6 +122,8 @@ void USceneHistoryManager::Undo() {
 }
 
 void USceneHistoryManager::Redo() {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_HistoryRedo);
+
     int32 NumApplied = 0;
     while (CurrentIndex < Transactions.Num()) {
         // if transaction has expired, it is effectively a no-op and so we will continue to Redo()
@@ -122,7 +137,9 @@ void USceneHistoryManager::Redo() {
             ++NumApplied;
         }
 
-        UE_LOG(LogTemp, Warning, TEXT("[UNDO] %s"), *Transactions[CurrentIndex].Description.ToString());
+        if (bLogChanges) {
+            UE_LOG(LogTemp, Warning, TEXT("[UNDO] %s"), *Transactions[CurrentIndex].Description.ToString());
+        }
         CurrentIndex = CurrentIndex + 1;
 
         if (!bContinue) {
@@ -1,7 +1,7 @@
 #include "Interaction/SceneObject.h"
 #include "DynamicMesh/DynamicMesh3.h"
 #include "DynamicMesh/DynamicMeshAABBTree3.h"
-#include "MeshDescriptionToDynamicMesh.h"
+#include "RuntimeToolsFramework/RuntimeMeshConversion.h"
 #include "MaterialDomain.h"
 #include "Materials/Material.h"
 
@@ -34,6 +34,7 @@ void USceneObject::Initialize(UWorld* TargetWorld, const FDynamicMesh3* InitialM
 
     *SourceMesh = *InitialMesh;
     MeshAABBTree->SetMesh(SourceMesh.Get(), true);
+    bMeshAABBTreeDirty = false;
 
     UpdateComponentMaterials(false);
 }
@@ -108,12 +109,43 @@ void USceneObject::UpdateComponentMaterials(bool bForceRefresh) {
 
 
 void USceneObject::UpdateSourceMesh(const FMeshDescription* MeshDescriptionIn) {
-    FMeshDescriptionToDynamicMesh Converter;
     FDynamicMesh3 TmpMesh;
-    Converter.Convert(MeshDescriptionIn, TmpMesh);
+    RuntimeMeshConversion::MeshDescriptionToDynamicMesh(*MeshDescriptionIn, TmpMesh);
     *SourceMesh = MoveTemp(TmpMesh);
 
     MeshAABBTree->SetMesh(SourceMesh.Get(), true);
+    bMeshAABBTreeDirty = false;
+}
+
+
+void USceneObject::UpdateSourceMeshRegion(
+    const FDynamicMesh3& Mesh, TArrayView<const int32> Triangles, bool bTopologyChanged
+) {
+    if (bTopologyChanged || SourceMesh->MaxVertexID() != Mesh.MaxVertexID()) {
+        // picking only needs the geometry
+        SourceMesh->Copy(Mesh, false, false, false, false);
+    } else {
+        for (int32 TriangleID : Triangles) {
+            if (Mesh.IsTriangle(TriangleID)) {
+                const FIndex3i Triangle = Mesh.GetTriangle(TriangleID);
+                for (int32 j = 0; j < 3; ++j) {
+                    SourceMesh->SetVertex(Triangle[j], Mesh.GetVertex(Triangle[j]));
+                }
+            }
+        }
+    }
+
+    // rebuilt lazily, so that a series of edits between two picks only rebuilds once
+    bMeshAABBTreeDirty = true;
+}
+
+
+USceneObject::FDynamicMeshAABBTree3& USceneObject::GetMeshAABBTree() {
+    if (bMeshAABBTreeDirty) {
+        MeshAABBTree->SetMesh(SourceMesh.Get(), true);
+        bMeshAABBTreeDirty = false;
+    }
+    return *MeshAABBTree;
 }
 
 
@@ -140,7 +172,7 @@ bool USceneObject::IntersectRay(
     if (MaxDistance > 0) {
         QueryOptions.MaxDistance = MaxDistance;
     }
-    NearestTriangle = MeshAABBTree->FindNearestHitTriangle(LocalRay, QueryOptions);
+    NearestTriangle = GetMeshAABBTree().FindNearestHitTriangle(LocalRay, QueryOptions);
     if (SourceMesh->IsTriangle(NearestTriangle)) {
         FIntrRay3Triangle3d IntrQuery =
             TMeshQueries<FDynamicMesh3>::TriangleIntersection(*SourceMesh, NearestTriangle, LocalRay);
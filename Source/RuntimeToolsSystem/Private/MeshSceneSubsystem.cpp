@@ -2,10 +2,16 @@
 #include "MaterialDomain.h"
 #include "Interaction/SceneObject.h"
 #include "Materials/Material.h"
+#include "Components/DynamicMeshComponent.h"
+#include "ToolsSubsystem.h"
+#include "RuntimeToolsStats.h"
 
 
 #define LOCTEXT_NAMESPACE "UMeshSceneSubsystem"
 
+DECLARE_CYCLE_STAT(TEXT("Scene Pick"), STAT_RuntimeTools_ScenePick, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("Scene Selection"), STAT_RuntimeTools_SceneSelection, STATGROUP_RuntimeTools);
+
 
 UMeshSceneSubsystem* UMeshSceneSubsystem::InstanceSingleton = nullptr;
 
@@ -156,6 +162,8 @@ bool UMeshSceneSubsystem::DeleteSelectedSceneObjects(AActor* SkipActor) {
 
 
 void UMeshSceneSubsystem::ClearSelection() {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_SceneSelection);
+
     if (SelectedSceneObjects.Num() > 0) {
         BeginSelectionChange();
 
@@ -173,6 +181,8 @@ void UMeshSceneSubsystem::ClearSelection() {
 void UMeshSceneSubsystem::SetSelected(
     USceneObject* SceneObject, bool bDeselect, bool bDeselectOthers
 ) {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_SceneSelection);
+
     if (bDeselect) {
         if (SelectedSceneObjects.Contains(SceneObject)) {
             BeginSelectionChange();
@@ -205,6 +215,8 @@ void UMeshSceneSubsystem::SetSelected(
 
 
 void UMeshSceneSubsystem::ToggleSelected(USceneObject* SceneObject) {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_SceneSelection);
+
     BeginSelectionChange();
 
     if (SelectedSceneObjects.Contains(SceneObject)) {
@@ -221,6 +233,8 @@ void UMeshSceneSubsystem::ToggleSelected(USceneObject* SceneObject) {
 
 
 void UMeshSceneSubsystem::SetSelection(const TArray<USceneObject*>& NewSceneObjects) {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_SceneSelection);
+
     BeginSelectionChange();
     SetSelectionInternal(NewSceneObjects);
     EndSelectionChange();
@@ -256,6 +270,8 @@ USceneObject* UMeshSceneSubsystem::FindNearestHitObject(
     FVector RayOrigin, FVector RayDirection, FVector& WorldHitPoint, float& HitDistance, int& NearestTriangle,
     FVector& TriBaryCoords, float MaxDistance
 ) {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_ScenePick);
+
     USceneObject* FoundHit = nullptr;
     float MinHitDistance = TNumericLimits<float>::Max();
 
@@ -319,6 +335,15 @@ void UMeshSceneSubsystem::AddSceneObjectInternal(USceneObject* Object, bool bIsU
 
     if (bIsUndoRedo) {
         Object->GetActor()->RegisterAllComponents();
+
+        // the updaters were released when the object was removed, and its chunks may have gone stale since (eg the
+        // selection highlight material). Tool targets and cached conversions are rebuilt when they are needed.
+        if (UToolsSubsystem* ToolsSubsystem = UToolsSubsystem::TryGet()) {
+            TInlineComponentArray<UDynamicMeshComponent*> MeshComponents(Object->GetActor());
+            for (UDynamicMeshComponent* Component : MeshComponents) {
+                ToolsSubsystem->RegisterMeshComponent(Component);
+            }
+        }
     }
 }
 
@@ -326,6 +351,14 @@ void UMeshSceneSubsystem::RemoveSceneObjectInternal(USceneObject* Object, bool b
     check(SceneObjects.Contains(Object));
     SceneObjects.Remove(Object);
 
+    // the Actor is kept alive for undo, so the tools state of its meshes has to be let go of explicitly
+    if (UToolsSubsystem* ToolsSubsystem = UToolsSubsystem::TryGet()) {
+        TInlineComponentArray<UDynamicMeshComponent*> MeshComponents(Object->GetActor());
+        for (UDynamicMeshComponent* Component : MeshComponents) {
+            ToolsSubsystem->ReleaseMeshComponent(Component);
+        }
+    }
+
     Object->GetActor()->UnregisterAllComponents(true);
 }
 
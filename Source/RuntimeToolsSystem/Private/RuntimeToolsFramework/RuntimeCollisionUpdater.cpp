@@ -0,0 +1,120 @@
+#include "RuntimeToolsFramework/RuntimeCollisionUpdater.h"
+#include "Components/DynamicMeshComponent.h"
+#include "UDynamicMesh.h"
+#include "HAL/PlatformTime.h"
+
+
+void URuntimeCollisionUpdater::AddComponent(UDynamicMeshComponent* Component) {
+    if (Component == nullptr || FindEntry(Component) != nullptr) {
+        return;
+    }
+
+    Component->bUseAsyncCooking = bUseAsyncCooking;
+
+    FComponentEntry& Entry = Components.AddDefaulted_GetRef();
+    Entry.Component = Component;
+    ApplyDeferral(Entry);
+
+    // also catches undo/redo, which do not go through the tool target. Components that do not defer rebuild their
+    // collision on these events themselves.
+    TWeakObjectPtr<UDynamicMeshComponent> WeakComponent(Component);
+    Entry.MeshChangedHandle = Component->GetDynamicMesh()->OnMeshChanged().AddWeakLambda(
+        this, [this, WeakComponent](UDynamicMesh*, FDynamicMeshChangeInfo) {
+            FComponentEntry* ChangedEntry = FindEntry(WeakComponent.Get());
+            if (ChangedEntry && ChangedEntry->bDeferred) {
+                ChangedEntry->bDirty = true;
+                ChangedEntry->LastChangeTime = FPlatformTime::Seconds();
+            }
+        }
+    );
+}
+
+
+void URuntimeCollisionUpdater::RemoveComponent(UDynamicMeshComponent* Component) {
+    const int32 Index = Components.IndexOfByPredicate([Component](const FComponentEntry& Entry) {
+        return Entry.Component.Get() == Component;
+    });
+    if (Component == nullptr || Index == INDEX_NONE) {
+        return;
+    }
+
+    FComponentEntry& Entry = Components[Index];
+    if (Component->GetDynamicMesh()) {
+        Component->GetDynamicMesh()->OnMeshChanged().Remove(Entry.MeshChangedHandle);
+    }
+    Component->SetDeferredCollisionUpdatesEnabled(false, false);
+    if (Entry.bDirty) {
+        UpdateCollision(Entry);
+    }
+    Components.RemoveAtSwap(Index);
+}
+
+
+void URuntimeCollisionUpdater::MarkCollisionDirty(UDynamicMeshComponent* Component) {
+    if (FComponentEntry* Entry = FindEntry(Component)) {
+        Entry->bDirty = true;
+        Entry->LastChangeTime = FPlatformTime::Seconds();
+        if (Entry->bDeferred == false) {
+            UpdateCollision(*Entry);
+        }
+    } else if (Component) {
+        // not managed, so nothing else would rebuild it
+        Component->UpdateCollision(false);
+    }
+}
+
+
+void URuntimeCollisionUpdater::FlushCollisionUpdates() {
+    for (FComponentEntry& Entry : Components) {
+        if (Entry.bDirty) {
+            UpdateCollision(Entry);
+        }
+    }
+}
+
+
+void URuntimeCollisionUpdater::Tick() {
+    const double CurrentTime = FPlatformTime::Seconds();
+    for (int32 k = Components.Num() - 1; k >= 0; --k) {
+        FComponentEntry& Entry = Components[k];
+        if (Entry.Component.IsValid() == false) {
+            Components.RemoveAtSwap(k);
+            continue;
+        }
+        if (Entry.bDeferred != bDeferCollisionUpdates) {
+            ApplyDeferral(Entry);
+        }
+        if (Entry.bDirty && CurrentTime - Entry.LastChangeTime >= CollisionUpdateDelay) {
+            UpdateCollision(Entry);
+        }
+    }
+}
+
+
+URuntimeCollisionUpdater::FComponentEntry* URuntimeCollisionUpdater::FindEntry(UDynamicMeshComponent* Component) {
+    return Components.FindByPredicate([Component](const FComponentEntry& Entry) {
+        return Entry.Component.Get() == Component;
+    });
+}
+
+
+void URuntimeCollisionUpdater::ApplyDeferral(FComponentEntry& Entry) {
+    Entry.bDeferred = bDeferCollisionUpdates;
+    if (UDynamicMeshComponent* Component = Entry.Component.Get()) {
+        Component->SetDeferredCollisionUpdatesEnabled(Entry.bDeferred, true);
+    }
+    // collision that is still dirty is rebuilt when deferral is turned off
+    if (Entry.bDeferred == false && Entry.bDirty) {
+        UpdateCollision(Entry);
+    }
+}
+
+
+void URuntimeCollisionUpdater::UpdateCollision(FComponentEntry& Entry) {
+    Entry.bDirty = false;
+    if (UDynamicMeshComponent* Component = Entry.Component.Get()) {
+        // not only if pending, region commits change the mesh without the Component noticing
+        Component->bUseAsyncCooking = bUseAsyncCooking;
+        Component->UpdateCollision(false);
+    }
+}
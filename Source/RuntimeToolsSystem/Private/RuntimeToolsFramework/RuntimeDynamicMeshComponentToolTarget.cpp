@@ -1,15 +1,126 @@
 #include "RuntimeToolsFramework/RuntimeDynamicMeshComponentToolTarget.h"
 #include "Components/DynamicMeshComponent.h"
-#include "DynamicMeshToMeshDescription.h"
-#include "MeshDescriptionToDynamicMesh.h"
+#include "UDynamicMesh.h"
+#include "RuntimeToolsFramework/RuntimeMeshConversion.h"
 #include "StaticMeshAttributes.h"
 #include "Materials/Material.h"
 #include "ModelingToolTargetUtil.h"
 #include "ToolsSubsystem.h"
+#include "MeshSceneSubsystem.h"
+#include "Interaction/SceneObject.h"
 
 
 #define LOCTEXT_NAMESPACE "URuntimeDynamicMeshComponentToolTarget"
 
+
+FRuntimeMeshDescriptionCache::~FRuntimeMeshDescriptionCache() {
+    for (TPair<FObjectKey, FEntry>& EntryPair : Entries) {
+        if (UDynamicMesh* Mesh = EntryPair.Value.Mesh.Get()) {
+            Mesh->OnMeshChanged().Remove(EntryPair.Value.MeshChangedHandle);
+        }
+    }
+}
+
+FRuntimeMeshDescriptionCache::FEntry& FRuntimeMeshDescriptionCache::FindOrAddEntry(UDynamicMesh* Mesh) {
+    const FObjectKey Key(Mesh);
+    if (FEntry* Found = Entries.Find(Key)) {
+        return *Found;
+    }
+
+    FEntry& Entry = Entries.Add(Key);
+    Entry.Mesh = Mesh;
+    Entry.MeshChangedHandle = Mesh->OnMeshChanged().AddLambda([this, Key](UDynamicMesh*, FDynamicMeshChangeInfo) {
+        if (FEntry* Changed = Entries.Find(Key)) {
+            Changed->ChangeStamp++;
+            Changed->MeshDescription.Reset();
+            Changed->Snapshot.Reset();
+        }
+    });
+    return Entry;
+}
+
+TSharedPtr<const FMeshDescription> FRuntimeMeshDescriptionCache::GetMeshDescription(UDynamicMesh* Mesh) {
+    FEntry& Entry = FindOrAddEntry(Mesh);
+    Entry.LastUsed = ++UseCounter;
+    if (Entry.MeshDescription.IsValid() && Entry.CachedChangeStamp == Entry.ChangeStamp) {
+        return Entry.MeshDescription;
+    }
+
+    TSharedPtr<FMeshDescription> MeshDescription =
+        MakeShared<FMeshDescription>(URuntimeDynamicMeshComponentToolTarget::MakeEmptyMeshDescription());
+    Mesh->ProcessMesh([&](const FDynamicMesh3& ReadMesh) {
+        RuntimeMeshConversion::DynamicMeshToMeshDescription(ReadMesh, *MeshDescription, true);
+    });
+    Entry.MeshDescription = MeshDescription;
+    Entry.CachedChangeStamp = Entry.ChangeStamp;
+
+    // Entry may be moved by Trim(), but the result is already held
+    TSharedPtr<const FMeshDescription> Result = Entry.MeshDescription;
+    Trim();
+    return Result;
+}
+
+TSharedPtr<const FDynamicMesh3, ESPMode::ThreadSafe> FRuntimeMeshDescriptionCache::GetMeshSnapshot(UDynamicMesh* Mesh) {
+    FEntry& Entry = FindOrAddEntry(Mesh);
+    Entry.LastUsed = ++UseCounter;
+    if (Entry.Snapshot.IsValid() && Entry.SnapshotChangeStamp == Entry.ChangeStamp) {
+        return Entry.Snapshot;
+    }
+
+    TSharedPtr<FDynamicMesh3, ESPMode::ThreadSafe> Snapshot = MakeShared<FDynamicMesh3, ESPMode::ThreadSafe>();
+    Mesh->ProcessMesh([&](const FDynamicMesh3& ReadMesh) { *Snapshot = ReadMesh; });
+    Entry.Snapshot = Snapshot;
+    Entry.SnapshotChangeStamp = Entry.ChangeStamp;
+
+    Trim();
+    return Snapshot;
+}
+
+uint64 FRuntimeMeshDescriptionCache::GetChangeStamp(UDynamicMesh* Mesh) const {
+    const FEntry* Entry = Entries.Find(FObjectKey(Mesh));
+    return (Entry && Entry->Mesh.IsValid()) ? Entry->ChangeStamp : 0;
+}
+
+void FRuntimeMeshDescriptionCache::Invalidate(UDynamicMesh* Mesh) {
+    if (FEntry* Entry = Entries.Find(FObjectKey(Mesh))) {
+        Entry->ChangeStamp++;
+        Entry->MeshDescription.Reset();
+        Entry->Snapshot.Reset();
+    }
+}
+
+void FRuntimeMeshDescriptionCache::Remove(UDynamicMesh* Mesh) {
+    FEntry Entry;
+    if (Entries.RemoveAndCopyValue(FObjectKey(Mesh), Entry) && Entry.Mesh.IsValid()) {
+        Entry.Mesh->OnMeshChanged().Remove(Entry.MeshChangedHandle);
+    }
+}
+
+void FRuntimeMeshDescriptionCache::Trim() {
+    // the delegate binding goes away with the mesh
+    for (auto It = Entries.CreateIterator(); It; ++It) {
+        if (It.Value().Mesh.IsValid() == false) {
+            It.RemoveCurrent();
+        }
+    }
+
+    // keep the entries (and so the change stamps) of live meshes, but release the older conversions/snapshots
+    TArray<FEntry*> Cached;
+    for (TPair<FObjectKey, FEntry>& EntryPair : Entries) {
+        if (EntryPair.Value.MeshDescription.IsValid() || EntryPair.Value.Snapshot.IsValid()) {
+            Cached.Add(&EntryPair.Value);
+        }
+    }
+    if (Cached.Num() > MaxCachedMeshes) {
+        Cached.Sort([](const FEntry& A, const FEntry& B) { return A.LastUsed > B.LastUsed; });
+        for (int32 k = FMath::Max(MaxCachedMeshes, 0); k < Cached.Num(); ++k) {
+            Cached[k]->MeshDescription.Reset();
+            Cached[k]->Snapshot.Reset();
+        }
+    }
+}
+
+
 bool URuntimeDynamicMeshComponentToolTarget::IsValid() const {
     if (!UPrimitiveComponentToolTarget::IsValid()) {
         return false;
@@ -68,22 +179,16 @@ const FMeshDescription* URuntimeDynamicMeshComponentToolTarget::GetMeshDescripti
 ) {
     check(IsValid());
 
-    if (bHaveCachedMeshDescription) {
-        return CachedMeshDescription.Get();
-    }
-
-    UDynamicMeshComponent* DynamicMeshComponent = Cast<UDynamicMeshComponent>(Component);
-
-    CachedMeshDescription = MakeUnique<FMeshDescription>(GetEmptyMeshDescription());
-
-    FDynamicMeshToMeshDescription Converter;
-    Converter.Convert(DynamicMeshComponent->GetMesh(), *CachedMeshDescription, true);
-
-    bHaveCachedMeshDescription = true;
+    // the cache only converts again if the mesh changed since this (or any other) target last asked for it
+    CachedMeshDescription = GetMeshDescriptionCache().GetMeshDescription(GetDynamicMeshContainer());
     return CachedMeshDescription.Get();
 }
 
 FMeshDescription URuntimeDynamicMeshComponentToolTarget::GetEmptyMeshDescription() {
+    return MakeEmptyMeshDescription();
+}
+
+FMeshDescription URuntimeDynamicMeshComponentToolTarget::MakeEmptyMeshDescription() {
     // FStaticMeshAttributes are the attribute set required by a UStaticMesh, and USkeletalMesh supports
     // all the same attributes. Lots of code assumes that these attributes are available, to the point
     // where a FMeshDescription is basically not usable without them
@@ -93,45 +198,165 @@ FMeshDescription URuntimeDynamicMeshComponentToolTarget::GetEmptyMeshDescription
     return MeshDescription;
 }
 
-void URuntimeDynamicMeshComponentToolTarget::InvalidateCachedMeshDescription() {
-    if (bHaveCachedMeshDescription) {
-        CachedMeshDescription = nullptr;
-        bHaveCachedMeshDescription = false;
+FRuntimeMeshDescriptionCache& URuntimeDynamicMeshComponentToolTarget::GetMeshDescriptionCache() {
+    // targets that were not built by the factory cache on their own
+    if (MeshDescriptionCache.IsValid() == false) {
+        MeshDescriptionCache = MakeShared<FRuntimeMeshDescriptionCache>();
     }
+    return *MeshDescriptionCache;
+}
+
+void URuntimeDynamicMeshComponentToolTarget::InvalidateCachedMeshDescription() {
+    // the shared conversion is invalidated by the mesh change itself
+    CachedMeshDescription.Reset();
 }
 
 
 void URuntimeDynamicMeshComponentToolTarget::CommitMeshDescription(
     const FCommitter& Committer, const FCommitMeshParameters& CommitMeshParams
+) {
+    CommitMeshDescriptionBuffer(Committer, false);
+}
+
+void URuntimeDynamicMeshComponentToolTarget::CommitMeshDescriptionEdit(const FCommitter& Committer) {
+    CommitMeshDescriptionBuffer(Committer, true);
+}
+
+void URuntimeDynamicMeshComponentToolTarget::CommitMeshDescriptionBuffer(
+    const FCommitter& Committer, bool bCopyCurrentMesh
 ) {
     if (ensure(IsValid()) == false) {
         return;
     }
 
-    // we are going to replace FDynamicMesh3 inside the UDynamicMesh, we will pass to a FMeshChange so we can just steal
-    // it here
-    UDynamicMesh* DynamicMesh = GetDynamicMeshContainer();
-    TSharedPtr<FDynamicMesh3> CurrentMesh(DynamicMesh->ExtractMesh().Release());
-
-    // run the Committer function to store to a temporary MeshDescription
-    FMeshDescription TempMeshDescription(*GetMeshDescription());
+    // run the Committer function in the shared commit buffer, which keeps its allocations between commits
+    FMeshDescription& CommitBuffer = GetMeshDescriptionCache().GetCommitBuffer();
+    if (bCopyCurrentMesh) {
+        CommitBuffer = *GetMeshDescription();
+    } else {
+        CommitBuffer.Empty();
+        FStaticMeshAttributes(CommitBuffer).Register();
+    }
     FCommitterParams CommitterParams;
-    CommitterParams.MeshDescriptionOut = &TempMeshDescription;
+    CommitterParams.MeshDescriptionOut = &CommitBuffer;
     Committer(CommitterParams);
 
-    // convert to FDynamicMesh3
-    FMeshDescriptionToDynamicMesh Converter;
-    TSharedPtr<FDynamicMesh3> NewMesh = MakeShared<FDynamicMesh3>();
-    NewMesh->EnableAttributes();
-    Converter.Convert(CommitterParams.MeshDescriptionOut, *NewMesh, true);
+    // convert directly into the mesh that will end up in the UDynamicMesh
+    TUniquePtr<FDynamicMesh3> NewMesh = MakeUnique<FDynamicMesh3>();
+    RuntimeMeshConversion::MeshDescriptionToDynamicMesh(*CommitterParams.MeshDescriptionOut, *NewMesh, true);
 
-    // update the UDynamicMesh
-    DynamicMesh->EditMesh([&](FDynamicMesh3& EditMesh) { EditMesh = *NewMesh; });
+    // move the new mesh into the UDynamicMesh and the old one out of it, and hand the old one over to the change.
+    // So neither mesh is copied, and the undo history does not hold a second copy of the current mesh.
+    UDynamicMesh* DynamicMesh = GetDynamicMeshContainer();
+    DynamicMesh->EditMesh([&](FDynamicMesh3& EditMesh) { Swap(EditMesh, *NewMesh); });
 
     // emit the change
     CommitDynamicMeshChange(
-        MakeUnique<FMeshReplacementChange>(CurrentMesh, NewMesh), LOCTEXT("RuntimeDynamicMeshChange", "MeshChange")
+        MakeUnique<FDynamicMeshSwapChange>(MoveTemp(NewMesh)), LOCTEXT("RuntimeDynamicMeshChange", "MeshChange")
+    );
+}
+
+
+void FDynamicMeshSwapChange::Apply(UObject* Object) {
+    SwapMeshes(Object);
+}
+
+void FDynamicMeshSwapChange::Revert(UObject* Object) {
+    SwapMeshes(Object);
+}
+
+void FDynamicMeshSwapChange::SwapMeshes(UObject* Object) {
+    UDynamicMeshComponent* Component = Cast<UDynamicMeshComponent>(Object);
+    if (ensure(Component && OtherMesh.IsValid())) {
+        // EditMesh() notifies the Component, which rebuilds its render data
+        Component->GetDynamicMesh()->EditMesh([this](FDynamicMesh3& EditMesh) { Swap(EditMesh, *OtherMesh); });
+    }
+}
+
+
+void URuntimeDynamicMeshComponentToolTarget::CommitMeshRegion(
+    TArrayView<const int32> Triangles, TFunctionRef<void(FDynamicMesh3&)> EditFunc, bool bTopologyChanged,
+    const FText& ChangeMessage
+) {
+    if (ensure(IsValid()) == false) {
+        return;
+    }
+
+    TUniquePtr<FDynamicMeshRegionChange> Change = MakeUnique<FDynamicMeshRegionChange>();
+    Change->Triangles = TArray<int32>(Triangles.GetData(), Triangles.Num());
+    Change->bTopologyChanged = bTopologyChanged;
+    Change->MeshDescriptionCache = MeshDescriptionCache;
+
+    ApplyRegionEdit(
+        GetDynamicMeshComponent(), Change->Triangles, bTopologyChanged, &GetMeshDescriptionCache(),
+        [&](FDynamicMesh3& EditMesh) {
+            FDynamicMeshChangeTracker ChangeTracker(&EditMesh);
+            ChangeTracker.BeginChange();
+            ChangeTracker.SaveTriangles(Change->Triangles, true);
+            EditFunc(EditMesh);
+            Change->MeshChange = ChangeTracker.EndChange();
+        }
     );
+
+    CommitDynamicMeshChange(MoveTemp(Change), ChangeMessage);
+}
+
+void URuntimeDynamicMeshComponentToolTarget::ApplyRegionEdit(
+    UDynamicMeshComponent* Component, const TArray<int32>& Triangles, bool bTopologyChanged,
+    FRuntimeMeshDescriptionCache* Cache, TFunctionRef<void(FDynamicMesh3&)> EditFunc
+) {
+    UDynamicMesh* DynamicMesh = Component->GetDynamicMesh();
+    if (bTopologyChanged) {
+        // the render buffer layout changes, so this needs the regular (full) update
+        DynamicMesh->EditMesh(EditFunc);
+    } else {
+        // Skip the change events, which would make the Component update the vertex buffers of the whole mesh, and
+        // only update the render chunks (see URuntimeRenderChunkUpdater) that contain the triangles in the region.
+        // The conversion cache does not see the edit, so tell it directly.
+        DynamicMesh->EditMesh(
+            EditFunc, EDynamicMeshChangeType::DeformationEdit,
+            EDynamicMeshAttributeChangeFlags::VertexPositions | EDynamicMeshAttributeChangeFlags::NormalsTangents, true
+        );
+        Component->FastNotifyTriangleVerticesUpdated(
+            Triangles, EMeshRenderAttributeFlags::Positions | EMeshRenderAttributeFlags::VertexNormals
+        );
+        if (Cache) {
+            Cache->Invalidate(DynamicMesh);
+        }
+        // the updaters only exist between InitializeToolsContext() and ShutdownToolsContext()
+        UToolsSubsystem* ToolsSubsystem = UToolsSubsystem::TryGet();
+        if (ToolsSubsystem && ToolsSubsystem->GetCollisionUpdater()) {
+            ToolsSubsystem->GetCollisionUpdater()->MarkCollisionDirty(Component);
+        }
+    }
+
+    UMeshSceneSubsystem* SceneSubsystem = UMeshSceneSubsystem::Get();
+    if (USceneObject* SceneObject = SceneSubsystem ? SceneSubsystem->FindSceneObjectByActor(Component->GetOwner())
+                                                   : nullptr) {
+        DynamicMesh->ProcessMesh([&](const FDynamicMesh3& Mesh) {
+            SceneObject->UpdateSourceMeshRegion(Mesh, Triangles, bTopologyChanged);
+        });
+    }
+}
+
+void FDynamicMeshRegionChange::Apply(UObject* Object) {
+    if (UDynamicMeshComponent* Component = Cast<UDynamicMeshComponent>(Object)) {
+        TSharedPtr<FRuntimeMeshDescriptionCache> Cache = MeshDescriptionCache.Pin();
+        URuntimeDynamicMeshComponentToolTarget::ApplyRegionEdit(
+            Component, Triangles, bTopologyChanged, Cache.Get(),
+            [this](FDynamicMesh3& EditMesh) { MeshChange->Apply(&EditMesh, false); }
+        );
+    }
+}
+
+void FDynamicMeshRegionChange::Revert(UObject* Object) {
+    if (UDynamicMeshComponent* Component = Cast<UDynamicMeshComponent>(Object)) {
+        TSharedPtr<FRuntimeMeshDescriptionCache> Cache = MeshDescriptionCache.Pin();
+        URuntimeDynamicMeshComponentToolTarget::ApplyRegionEdit(
+            Component, Triangles, bTopologyChanged, Cache.Get(),
+            [this](FDynamicMesh3& EditMesh) { MeshChange->Apply(&EditMesh, true); }
+        );
+    }
 }
 
 
@@ -165,6 +390,18 @@ FDynamicMesh3 URuntimeDynamicMeshComponentToolTarget::GetDynamicMesh() {
     return Mesh;
 }
 
+void URuntimeDynamicMeshComponentToolTarget::ProcessReadOnlyMesh(
+    TFunctionRef<void(const FDynamicMesh3&)> ProcessFunc
+) {
+    check(IsValid());
+    GetDynamicMeshContainer()->ProcessMesh(ProcessFunc);
+}
+
+TSharedPtr<const FDynamicMesh3, ESPMode::ThreadSafe> URuntimeDynamicMeshComponentToolTarget::GetMeshSnapshot() {
+    check(IsValid());
+    return GetMeshDescriptionCache().GetMeshSnapshot(GetDynamicMeshContainer());
+}
+
 void URuntimeDynamicMeshComponentToolTarget::CommitDynamicMesh(
     const FDynamicMesh3& UpdatedMesh, const FDynamicMeshCommitInfo& CommitInfo
 ) {
@@ -197,10 +434,46 @@ bool URuntimeDynamicMeshComponentToolTargetFactory::CanBuildTarget(
 UToolTarget* URuntimeDynamicMeshComponentToolTargetFactory::BuildTarget(
     UObject* SourceObject, const FToolTargetTypeRequirements& Requirements
 ) {
+    PruneCachedTargets();
+
+    UDynamicMeshComponent* Component = Cast<UDynamicMeshComponent>(SourceObject);
+    for (URuntimeDynamicMeshComponentToolTarget* CachedTarget : CachedTargets) {
+        if (CachedTarget->Component.Get() == Component) {
+            return CachedTarget;
+        }
+    }
+
     URuntimeDynamicMeshComponentToolTarget* Target = NewObject<URuntimeDynamicMeshComponentToolTarget>(this);
-    Target->Component = Cast<UDynamicMeshComponent>(SourceObject);
+    Target->Component = Component;
+    Target->MeshDescriptionCache = MeshDescriptionCache;
+    if (Component->IsRegistered()) {
+        CachedTargets.Add(Target);
+    }
+
+    // commits and undo/redo of this Component then no longer rebuild its collision synchronously, and region edits
+    // only update the render chunks they touch
+    if (UToolsSubsystem* ToolsSubsystem = UToolsSubsystem::TryGet()) {
+        ToolsSubsystem->RegisterMeshComponent(Target->GetDynamicMeshComponent());
+    }
     return Target;
 }
 
+void URuntimeDynamicMeshComponentToolTargetFactory::ReleaseComponent(UDynamicMeshComponent* Component) {
+    if (Component == nullptr) {
+        return;
+    }
+    CachedTargets.RemoveAllSwap([Component](const URuntimeDynamicMeshComponentToolTarget* Target) {
+        return Target != nullptr && Target->Component.Get() == Component;
+    });
+    MeshDescriptionCache->Remove(Component->GetDynamicMesh());
+    PruneCachedTargets();
+}
+
+void URuntimeDynamicMeshComponentToolTargetFactory::PruneCachedTargets() {
+    CachedTargets.RemoveAllSwap([](const URuntimeDynamicMeshComponentToolTarget* Target) {
+        return Target == nullptr || Target->IsValid() == false || Target->Component->IsRegistered() == false;
+    });
+}
+
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,506 @@
+#include "RuntimeToolsFramework/RuntimeMeshConversion.h"
+#include "DynamicMesh/DynamicMeshAttributeSet.h"
+#include "DynamicMeshToMeshDescription.h"
+#include "MeshDescriptionToDynamicMesh.h"
+#include "MeshDescriptionBuilder.h"
+#include "StaticMeshAttributes.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "RuntimeToolsStats.h"
+#include <atomic>
+
+using namespace UE::Geometry;
+
+
+DECLARE_CYCLE_STAT(
+    TEXT("MeshDescription To DynamicMesh"), STAT_RuntimeTools_MeshDescriptionToDynamicMesh, STATGROUP_RuntimeTools
+);
+DECLARE_CYCLE_STAT(
+    TEXT("DynamicMesh To MeshDescription"), STAT_RuntimeTools_DynamicMeshToMeshDescription, STATGROUP_RuntimeTools
+);
+
+static TAutoConsoleVariable<int32> CVarParallelConversionThreshold(
+    TEXT("RuntimeTools.ParallelConversionThreshold"), 100000,
+    TEXT("Meshes with at least this many triangles are converted between FMeshDescription and FDynamicMesh3 in "
+         "parallel chunks. 0 always uses the engine converters.")
+);
+
+
+namespace RuntimeMeshConversionLocals {
+
+// number of vertices/triangles per task
+static constexpr int32 ChunkSize = 16384;
+
+static bool UseParallelPath(int32 NumTriangles) {
+    const int32 Threshold = CVarParallelConversionThreshold.GetValueOnAnyThread();
+    return Threshold > 0 && NumTriangles >= Threshold;
+}
+
+// call ChunkFunc(Start, End) for consecutive ranges of [0, Num), in parallel
+static void ParallelForChunks(int32 Num, TFunctionRef<void(int32, int32)> ChunkFunc) {
+    const int32 NumChunks = FMath::DivideAndRoundUp(Num, ChunkSize);
+    ParallelFor(NumChunks, [&](int32 Chunk) {
+        ChunkFunc(Chunk * ChunkSize, FMath::Min((Chunk + 1) * ChunkSize, Num));
+    });
+}
+
+
+// Set up Overlay with one element per distinct value among the vertex instances of each vertex, so that instances
+// that share a vertex and a value are welded (like the engine converter does). The distinct values are found per
+// vertex in parallel, only appending the elements and setting the triangles is serial.
+template <typename ValueType, typename OverlayType>
+static void WeldOverlay(
+    const FMeshDescription& MeshDescription, TArrayView<const FIndex3i> TriangleVertices,
+    TArrayView<const FIndex3i> TriangleInstances, OverlayType& Overlay,
+    TFunctionRef<ValueType(FVertexInstanceID)> GetValue
+) {
+    const int32 NumVertices = MeshDescription.Vertices().Num();
+
+    // index of each instance's value among the distinct values of its vertex
+    TArray<int32> InstanceElement;
+    InstanceElement.SetNumUninitialized(MeshDescription.VertexInstances().GetArraySize());
+
+    // number of distinct values per vertex, turned into the first element of each vertex below
+    TArray<int32> VertexElementStart;
+    VertexElementStart.SetNumUninitialized(NumVertices + 1);
+    VertexElementStart[0] = 0;
+
+    ParallelForChunks(NumVertices, [&](int32 Start, int32 End) {
+        TArray<ValueType, TInlineAllocator<16>> Distinct;
+        for (int32 VertexID = Start; VertexID < End; ++VertexID) {
+            Distinct.Reset();
+            for (const FVertexInstanceID InstanceID : MeshDescription.GetVertexVertexInstanceIDs(FVertexID(VertexID))) {
+                const ValueType Value = GetValue(InstanceID);
+                int32 Index = Distinct.IndexOfByKey(Value);
+                if (Index == INDEX_NONE) {
+                    Index = Distinct.Add(Value);
+                }
+                InstanceElement[InstanceID.GetValue()] = Index;
+            }
+            VertexElementStart[VertexID + 1] = Distinct.Num();
+        }
+    });
+    for (int32 VertexID = 0; VertexID < NumVertices; ++VertexID) {
+        VertexElementStart[VertexID + 1] += VertexElementStart[VertexID];
+    }
+
+    TArray<ValueType> ElementValues;
+    ElementValues.SetNumUninitialized(VertexElementStart[NumVertices]);
+    ParallelForChunks(NumVertices, [&](int32 Start, int32 End) {
+        for (int32 VertexID = Start; VertexID < End; ++VertexID) {
+            for (const FVertexInstanceID InstanceID : MeshDescription.GetVertexVertexInstanceIDs(FVertexID(VertexID))) {
+                const int32 Element = VertexElementStart[VertexID] + InstanceElement[InstanceID.GetValue()];
+                ElementValues[Element] = GetValue(InstanceID);
+            }
+        }
+    });
+
+    Overlay.ClearElements();
+    for (const ValueType& Value : ElementValues) {
+        Overlay.AppendElement(Value);
+    }
+    for (int32 TriangleID = 0; TriangleID < TriangleVertices.Num(); ++TriangleID) {
+        const FIndex3i& Vertices = TriangleVertices[TriangleID];
+        const FIndex3i& Instances = TriangleInstances[TriangleID];
+        Overlay.SetTriangle(
+            TriangleID, FIndex3i(
+                            VertexElementStart[Vertices.A] + InstanceElement[Instances.A],
+                            VertexElementStart[Vertices.B] + InstanceElement[Instances.B],
+                            VertexElementStart[Vertices.C] + InstanceElement[Instances.C]
+                        )
+        );
+    }
+}
+
+
+// @return false if MeshDescription is not supported by the parallel path (Mesh is left in an undefined state then)
+static bool MeshDescriptionToDynamicMeshParallel(
+    const FMeshDescription& MeshDescription, FDynamicMesh3& Mesh, bool bCopyTangents
+) {
+    const int32 NumVertices = MeshDescription.Vertices().Num();
+    const int32 NumTriangles = MeshDescription.Triangles().Num();
+
+    // element IDs are used as array indices and have to map 1:1 to the FDynamicMesh3 IDs
+    if (NumVertices != MeshDescription.Vertices().GetArraySize() ||
+        NumTriangles != MeshDescription.Triangles().GetArraySize() ||
+        MeshDescription.VertexInstances().Num() != MeshDescription.VertexInstances().GetArraySize()) {
+        return false;
+    }
+
+    FStaticMeshConstAttributes Attributes(MeshDescription);
+    TVertexAttributesConstRef<FVector3f> Positions = Attributes.GetVertexPositions();
+    TTriangleAttributesConstRef<int32> TriGroups =
+        MeshDescription.TriangleAttributes().GetAttributesRef<int32>(ExtendedMeshAttribute::PolyTriGroups);
+
+    //
+    // gather vertices and triangles
+    //
+
+    TArray<FVector3d> VertexPositions;
+    VertexPositions.SetNumUninitialized(NumVertices);
+    ParallelForChunks(NumVertices, [&](int32 Start, int32 End) {
+        for (int32 VertexID = Start; VertexID < End; ++VertexID) {
+            VertexPositions[VertexID] = FVector3d(Positions[FVertexID(VertexID)]);
+        }
+    });
+
+    TArray<FIndex3i> TriangleVertices, TriangleInstances;
+    TArray<int32> TriangleGroups, TriangleMaterials;
+    TriangleVertices.SetNumUninitialized(NumTriangles);
+    TriangleInstances.SetNumUninitialized(NumTriangles);
+    TriangleGroups.SetNumUninitialized(NumTriangles);
+    TriangleMaterials.SetNumUninitialized(NumTriangles);
+    ParallelForChunks(NumTriangles, [&](int32 Start, int32 End) {
+        for (int32 k = Start; k < End; ++k) {
+            const FTriangleID TriangleID(k);
+            TArrayView<const FVertexID> Vertices = MeshDescription.GetTriangleVertices(TriangleID);
+            TArrayView<const FVertexInstanceID> Instances = MeshDescription.GetTriangleVertexInstances(TriangleID);
+            TriangleVertices[k] = FIndex3i(Vertices[0].GetValue(), Vertices[1].GetValue(), Vertices[2].GetValue());
+            TriangleInstances[k] = FIndex3i(Instances[0].GetValue(), Instances[1].GetValue(), Instances[2].GetValue());
+
+            const int32 PolygonGroup = MeshDescription.GetTrianglePolygonGroup(TriangleID).GetValue();
+            TriangleMaterials[k] = PolygonGroup;
+            TriangleGroups[k] = TriGroups.IsValid() ? TriGroups[TriangleID] : PolygonGroup;
+        }
+    });
+
+    // Element creation is serial. The IDs are allocated in order, so they match the MeshDescription IDs, unless a
+    // triangle is rejected (eg non-manifold), which the engine converter handles by splitting vertices.
+    Mesh.Clear();
+    Mesh.EnableTriangleGroups();
+    for (const FVector3d& Position : VertexPositions) {
+        Mesh.AppendVertex(Position);
+    }
+    for (int32 TriangleID = 0; TriangleID < NumTriangles; ++TriangleID) {
+        if (Mesh.AppendTriangle(TriangleVertices[TriangleID], TriangleGroups[TriangleID]) != TriangleID) {
+            return false;
+        }
+    }
+
+    //
+    // attributes
+    //
+
+    Mesh.EnableAttributes();
+    FDynamicMeshAttributeSet* MeshAttributes = Mesh.Attributes();
+
+    MeshAttributes->EnableMaterialID();
+    FDynamicMeshMaterialAttribute* MaterialIDs = MeshAttributes->GetMaterialID();
+    ParallelForChunks(NumTriangles, [&](int32 Start, int32 End) {
+        for (int32 TriangleID = Start; TriangleID < End; ++TriangleID) {
+            MaterialIDs->SetValue(TriangleID, TriangleMaterials[TriangleID]);
+        }
+    });
+
+    TVertexInstanceAttributesConstRef<FVector3f> Normals = Attributes.GetVertexInstanceNormals();
+    if (Normals.IsValid()) {
+        WeldOverlay<FVector3f>(
+            MeshDescription, TriangleVertices, TriangleInstances, *MeshAttributes->PrimaryNormals(),
+            [&](FVertexInstanceID InstanceID) { return Normals[InstanceID]; }
+        );
+    }
+
+    TVertexInstanceAttributesConstRef<FVector2f> UVs = Attributes.GetVertexInstanceUVs();
+    const int32 NumUVLayers = UVs.IsValid() ? UVs.GetNumChannels() : 0;
+    MeshAttributes->SetNumUVLayers(NumUVLayers);
+    for (int32 Layer = 0; Layer < NumUVLayers; ++Layer) {
+        WeldOverlay<FVector2f>(
+            MeshDescription, TriangleVertices, TriangleInstances, *MeshAttributes->GetUVLayer(Layer),
+            [&](FVertexInstanceID InstanceID) { return UVs.Get(InstanceID, Layer); }
+        );
+    }
+
+    // only create a color overlay if there are actual colors, not just the default white
+    TVertexInstanceAttributesConstRef<FVector4f> Colors = Attributes.GetVertexInstanceColors();
+    std::atomic<bool> bHaveColors{false};
+    if (Colors.IsValid()) {
+        ParallelForChunks(MeshDescription.VertexInstances().Num(), [&](int32 Start, int32 End) {
+            for (int32 k = Start; k < End && bHaveColors.load(std::memory_order_relaxed) == false; ++k) {
+                if (Colors[FVertexInstanceID(k)] != FVector4f::One()) {
+                    bHaveColors = true;
+                }
+            }
+        });
+    }
+    if (bHaveColors) {
+        MeshAttributes->EnablePrimaryColors();
+        WeldOverlay<FVector4f>(
+            MeshDescription, TriangleVertices, TriangleInstances, *MeshAttributes->PrimaryColors(),
+            [&](FVertexInstanceID InstanceID) { return Colors[InstanceID]; }
+        );
+    }
+
+    TVertexInstanceAttributesConstRef<FVector3f> Tangents = Attributes.GetVertexInstanceTangents();
+    TVertexInstanceAttributesConstRef<float> BinormalSigns = Attributes.GetVertexInstanceBinormalSigns();
+    if (bCopyTangents && Normals.IsValid() && Tangents.IsValid() && BinormalSigns.IsValid()) {
+        MeshAttributes->EnableTangents();
+        WeldOverlay<FVector3f>(
+            MeshDescription, TriangleVertices, TriangleInstances, *MeshAttributes->PrimaryTangents(),
+            [&](FVertexInstanceID InstanceID) { return Tangents[InstanceID]; }
+        );
+        WeldOverlay<FVector3f>(
+            MeshDescription, TriangleVertices, TriangleInstances, *MeshAttributes->PrimaryBiTangents(),
+            [&](FVertexInstanceID InstanceID) {
+                return FVector3f::CrossProduct(Normals[InstanceID], Tangents[InstanceID]) * BinormalSigns[InstanceID];
+            }
+        );
+    }
+
+    return true;
+}
+
+
+// element IDs of the attribute overlays at one triangle corner. Corners of a vertex with the same key share a vertex
+// instance in the converted MeshDescription.
+using FCornerKey = TArray<int32, TInlineAllocator<16>>;
+
+
+// @return false if Mesh is not supported by the parallel path (MeshDescription is not modified then)
+static bool DynamicMeshToMeshDescriptionParallel(
+    const FDynamicMesh3& Mesh, FMeshDescription& MeshDescription, bool bCopyTangents
+) {
+    // vertex/triangle IDs are used as MeshDescription IDs
+    if (Mesh.IsCompact() == false) {
+        return false;
+    }
+
+    const int32 NumVertices = Mesh.VertexCount();
+    const int32 NumTriangles = Mesh.TriangleCount();
+    const FDynamicMeshAttributeSet* MeshAttributes = Mesh.Attributes();
+    const FDynamicMeshMaterialAttribute* MaterialIDs =
+        (MeshAttributes && MeshAttributes->HasMaterialID()) ? MeshAttributes->GetMaterialID() : nullptr;
+
+    const FDynamicMeshNormalOverlay* NormalOverlay = MeshAttributes ? MeshAttributes->PrimaryNormals() : nullptr;
+    const FDynamicMeshColorOverlay* ColorOverlay =
+        (MeshAttributes && MeshAttributes->HasPrimaryColors()) ? MeshAttributes->PrimaryColors() : nullptr;
+    const bool bHaveTangents = bCopyTangents && NormalOverlay && MeshAttributes->HasTangentSpace();
+    const int32 NumUVLayers = MeshAttributes ? MeshAttributes->NumUVLayers() : 0;
+
+    //
+    // Weld the triangle corners into vertex instances, like the engine converter: the corners around each vertex
+    // that use the same normal/tangent/UV/color elements share an instance. The distinct corners are found per vertex
+    // in parallel, the instances of vertex v get the IDs VertexInstanceStart[v] + [0, number of distinct corners).
+    //
+
+    auto GetCornerKey = [&](int32 TriangleID, int32 Corner, FCornerKey& Key) {
+        auto AddElement = [&](const auto* Overlay) {
+            const bool bIsSet = Overlay->IsSetTriangle(TriangleID);
+            Key.Add(bIsSet ? Overlay->GetTriangle(TriangleID)[Corner] : IndexConstants::InvalidID);
+        };
+        Key.Reset();
+        if (NormalOverlay) {
+            AddElement(NormalOverlay);
+        }
+        if (bHaveTangents) {
+            AddElement(MeshAttributes->PrimaryTangents());
+            AddElement(MeshAttributes->PrimaryBiTangents());
+        }
+        for (int32 Layer = 0; Layer < NumUVLayers; ++Layer) {
+            AddElement(MeshAttributes->GetUVLayer(Layer));
+        }
+        if (ColorOverlay) {
+            AddElement(ColorOverlay);
+        }
+    };
+
+    // index of the instance of corner 3*t+j among the instances of its vertex, and whether it is the first corner of
+    // that instance (which the instance attributes are then copied from)
+    TArray<int32> CornerInstance;
+    CornerInstance.SetNumUninitialized(3 * NumTriangles);
+    TArray<uint8> CornerIsFirst;
+    CornerIsFirst.SetNumZeroed(3 * NumTriangles);
+
+    // number of instances per vertex, turned into the first instance of each vertex below
+    TArray<int32> VertexInstanceStart;
+    VertexInstanceStart.SetNumUninitialized(NumVertices + 1);
+    VertexInstanceStart[0] = 0;
+
+    ParallelForChunks(NumVertices, [&](int32 Start, int32 End) {
+        TArray<FCornerKey, TInlineAllocator<16>> Distinct;
+        FCornerKey Key;
+        for (int32 VertexID = Start; VertexID < End; ++VertexID) {
+            Distinct.Reset();
+            Mesh.EnumerateVertexTriangles(VertexID, [&](int32 TriangleID) {
+                const int32 Corner = Mesh.GetTriangle(TriangleID).IndexOf(VertexID);
+                GetCornerKey(TriangleID, Corner, Key);
+                int32 Index = Distinct.IndexOfByKey(Key);
+                if (Index == INDEX_NONE) {
+                    Index = Distinct.Add(Key);
+                    CornerIsFirst[3 * TriangleID + Corner] = 1;
+                }
+                CornerInstance[3 * TriangleID + Corner] = Index;
+            });
+            VertexInstanceStart[VertexID + 1] = Distinct.Num();
+        }
+    });
+    for (int32 VertexID = 0; VertexID < NumVertices; ++VertexID) {
+        VertexInstanceStart[VertexID + 1] += VertexInstanceStart[VertexID];
+    }
+    const int32 NumInstances = VertexInstanceStart[NumVertices];
+
+    auto GetInstanceID = [&](const FIndex3i& Triangle, int32 TriangleID, int32 Corner) {
+        return FVertexInstanceID(VertexInstanceStart[Triangle[Corner]] + CornerInstance[3 * TriangleID + Corner]);
+    };
+
+    MeshDescription.Empty();
+    FStaticMeshAttributes Attributes(MeshDescription);
+    if (MeshDescription.TriangleAttributes().HasAttribute(ExtendedMeshAttribute::PolyTriGroups) == false) {
+        MeshDescription.TriangleAttributes().RegisterAttribute<int32>(
+            ExtendedMeshAttribute::PolyTriGroups, 1, 0, EMeshAttributeFlags::AutoGenerated
+        );
+    }
+
+    //
+    // Element creation is serial. The IDs are allocated in order, so the vertex IDs match the Mesh vertex IDs, and
+    // the instances of each vertex are consecutive, starting at VertexInstanceStart.
+    //
+
+    // material IDs become polygon groups
+    int32 NumPolygonGroups = 1;
+    if (MaterialIDs) {
+        for (int32 TriangleID = 0; TriangleID < NumTriangles; ++TriangleID) {
+            NumPolygonGroups = FMath::Max(NumPolygonGroups, MaterialIDs->GetValue(TriangleID) + 1);
+        }
+    }
+    MeshDescription.ReserveNewPolygonGroups(NumPolygonGroups);
+    for (int32 k = 0; k < NumPolygonGroups; ++k) {
+        MeshDescription.CreatePolygonGroup();
+    }
+
+    MeshDescription.ReserveNewVertices(NumVertices);
+    MeshDescription.ReserveNewVertexInstances(NumInstances);
+    for (int32 VertexID = 0; VertexID < NumVertices; ++VertexID) {
+        MeshDescription.CreateVertex();
+        for (int32 k = VertexInstanceStart[VertexID]; k < VertexInstanceStart[VertexID + 1]; ++k) {
+            MeshDescription.CreateVertexInstance(FVertexID(VertexID));
+        }
+    }
+    check(MeshDescription.VertexInstances().Num() == NumInstances);
+
+    MeshDescription.ReserveNewTriangles(NumTriangles);
+    MeshDescription.ReserveNewPolygons(NumTriangles);
+    MeshDescription.ReserveNewEdges(3 * NumTriangles / 2);
+    for (int32 TriangleID = 0; TriangleID < NumTriangles; ++TriangleID) {
+        const FIndex3i Triangle = Mesh.GetTriangle(TriangleID);
+        FVertexInstanceID Instances[3];
+        for (int32 j = 0; j < 3; ++j) {
+            Instances[j] = GetInstanceID(Triangle, TriangleID, j);
+        }
+        const int32 PolygonGroup = MaterialIDs ? FMath::Max(MaterialIDs->GetValue(TriangleID), 0) : 0;
+        MeshDescription.CreateTriangle(FPolygonGroupID(PolygonGroup), MakeArrayView(Instances, 3));
+    }
+
+    //
+    // attributes
+    //
+
+    TVertexAttributesRef<FVector3f> Positions = Attributes.GetVertexPositions();
+    ParallelForChunks(NumVertices, [&](int32 Start, int32 End) {
+        for (int32 VertexID = Start; VertexID < End; ++VertexID) {
+            Positions.Set(FVertexID(VertexID), FVector3f(Mesh.GetVertex(VertexID)));
+        }
+    });
+
+    TVertexInstanceAttributesRef<FVector3f> Normals = Attributes.GetVertexInstanceNormals();
+    TVertexInstanceAttributesRef<FVector3f> Tangents = Attributes.GetVertexInstanceTangents();
+    TVertexInstanceAttributesRef<float> BinormalSigns = Attributes.GetVertexInstanceBinormalSigns();
+    TVertexInstanceAttributesRef<FVector2f> UVs = Attributes.GetVertexInstanceUVs();
+    TVertexInstanceAttributesRef<FVector4f> Colors = Attributes.GetVertexInstanceColors();
+    TTriangleAttributesRef<int32> TriGroups =
+        MeshDescription.TriangleAttributes().GetAttributesRef<int32>(ExtendedMeshAttribute::PolyTriGroups);
+    UVs.SetNumChannels(FMath::Max(NumUVLayers, 1));
+
+    // every instance is written once, from its first corner
+    ParallelForChunks(NumTriangles, [&](int32 Start, int32 End) {
+        for (int32 TriangleID = Start; TriangleID < End; ++TriangleID) {
+            TriGroups.Set(FTriangleID(TriangleID), Mesh.HasTriangleGroups() ? Mesh.GetTriangleGroup(TriangleID) : 0);
+
+            const FIndex3i Triangle = Mesh.GetTriangle(TriangleID);
+            const bool bHaveNormals = NormalOverlay && NormalOverlay->IsSetTriangle(TriangleID);
+            const FIndex3i NormalTriangle = bHaveNormals ? NormalOverlay->GetTriangle(TriangleID) : FIndex3i::Invalid();
+            for (int32 j = 0; j < 3; ++j) {
+                if (CornerIsFirst[3 * TriangleID + j] == 0) {
+                    continue;
+                }
+                const FVertexInstanceID InstanceID = GetInstanceID(Triangle, TriangleID, j);
+                if (bHaveNormals) {
+                    const FVector3f Normal = NormalOverlay->GetElement(NormalTriangle[j]);
+                    Normals.Set(InstanceID, Normal);
+
+                    if (bHaveTangents && MeshAttributes->PrimaryTangents()->IsSetTriangle(TriangleID) &&
+                        MeshAttributes->PrimaryBiTangents()->IsSetTriangle(TriangleID)) {
+                        const FVector3f Tangent =
+                            MeshAttributes->PrimaryTangents()->GetElementAtVertex(TriangleID, Triangle[j]);
+                        const FVector3f BiTangent =
+                            MeshAttributes->PrimaryBiTangents()->GetElementAtVertex(TriangleID, Triangle[j]);
+                        Tangents.Set(InstanceID, Tangent);
+                        const float Sign = FVector3f::CrossProduct(Normal, Tangent).Dot(BiTangent) < 0 ? -1.0f : 1.0f;
+                        BinormalSigns.Set(InstanceID, Sign);
+                    }
+                }
+                for (int32 Layer = 0; Layer < NumUVLayers; ++Layer) {
+                    const FDynamicMeshUVOverlay* UVOverlay = MeshAttributes->GetUVLayer(Layer);
+                    if (UVOverlay->IsSetTriangle(TriangleID)) {
+                        UVs.Set(InstanceID, Layer, UVOverlay->GetElement(UVOverlay->GetTriangle(TriangleID)[j]));
+                    }
+                }
+                if (ColorOverlay && ColorOverlay->IsSetTriangle(TriangleID)) {
+                    Colors.Set(InstanceID, ColorOverlay->GetElement(ColorOverlay->GetTriangle(TriangleID)[j]));
+                }
+            }
+        }
+    });
+
+    // edges along normal seams are hard, like in the engine converter
+    if (NormalOverlay) {
+        TEdgeAttributesRef<bool> EdgeHardnesses = Attributes.GetEdgeHardnesses();
+        ParallelForChunks(MeshDescription.Edges().Num(), [&](int32 Start, int32 End) {
+            for (int32 k = Start; k < End; ++k) {
+                const FEdgeID EdgeID(k);
+                const int32 MeshEdgeID = Mesh.FindEdge(
+                    MeshDescription.GetEdgeVertex(EdgeID, 0).GetValue(),
+                    MeshDescription.GetEdgeVertex(EdgeID, 1).GetValue()
+                );
+                const bool bSeam = MeshEdgeID != IndexConstants::InvalidID && NormalOverlay->IsSeamEdge(MeshEdgeID);
+                EdgeHardnesses.Set(EdgeID, bSeam);
+            }
+        });
+    }
+
+    return true;
+}
+
+}  // namespace RuntimeMeshConversionLocals
+
+
+void RuntimeMeshConversion::MeshDescriptionToDynamicMesh(
+    const FMeshDescription& MeshDescription, FDynamicMesh3& Mesh, bool bCopyTangents
+) {
+    using namespace RuntimeMeshConversionLocals;
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_MeshDescriptionToDynamicMesh);
+
+    if (UseParallelPath(MeshDescription.Triangles().Num()) &&
+        MeshDescriptionToDynamicMeshParallel(MeshDescription, Mesh, bCopyTangents)) {
+        return;
+    }
+
+    Mesh.Clear();
+    FMeshDescriptionToDynamicMesh Converter;
+    Converter.Convert(&MeshDescription, Mesh, bCopyTangents);
+}
+
+
+void RuntimeMeshConversion::DynamicMeshToMeshDescription(
+    const FDynamicMesh3& Mesh, FMeshDescription& MeshDescription, bool bCopyTangents
+) {
+    using namespace RuntimeMeshConversionLocals;
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_DynamicMeshToMeshDescription);
+
+    if (UseParallelPath(Mesh.TriangleCount()) &&
+        DynamicMeshToMeshDescriptionParallel(Mesh, MeshDescription, bCopyTangents)) {
+        return;
+    }
+
+    FDynamicMeshToMeshDescription Converter;
+    Converter.Convert(&Mesh, MeshDescription, bCopyTangents);
+}
@@ -0,0 +1,126 @@
+#include "RuntimeToolsFramework/RuntimeRenderChunkUpdater.h"
+#include "Components/DynamicMeshComponent.h"
+#include "Components/MeshRenderDecomposition.h"
+#include "TargetInterfaces/MaterialProvider.h"
+#include "UDynamicMesh.h"
+#include "HAL/IConsoleManager.h"
+#include "RuntimeToolsStats.h"
+
+using namespace UE::Geometry;
+
+
+DECLARE_CYCLE_STAT(TEXT("Render Chunks Rebuild"), STAT_RuntimeTools_RenderChunksRebuild, STATGROUP_RuntimeTools);
+
+static TAutoConsoleVariable<int32> CVarRenderChunkSize(
+    TEXT("RuntimeTools.RenderChunkSize"), 1 << 14,
+    TEXT("Maximum number of triangles per render chunk of edited mesh components. Region edits only rebuild the "
+         "chunks they touch. 0 disables chunking for components added afterwards.")
+);
+
+
+void URuntimeRenderChunkUpdater::AddComponent(UDynamicMeshComponent* Component) {
+    if (Component == nullptr || FindEntry(Component) != nullptr || CVarRenderChunkSize.GetValueOnGameThread() <= 0) {
+        return;
+    }
+
+    FComponentEntry& Entry = Components.AddDefaulted_GetRef();
+    Entry.Component = Component;
+    RebuildChunks(Entry);
+
+    // The chunks refer to triangle IDs, so they have to follow every change that may alter the topology, including
+    // undo/redo that do not go through the tool target. (The change stamps alone do not tell, as mesh replacements
+    // swap them with the mesh.) The Component only re-creates its render proxy at the end of the frame, so it picks
+    // up the new chunks regardless of which of the two handles the event first.
+    TWeakObjectPtr<UDynamicMeshComponent> WeakComponent(Component);
+    Entry.MeshChangedHandle = Component->GetDynamicMesh()->OnMeshChanged().AddWeakLambda(
+        this, [this, WeakComponent](UDynamicMesh*, FDynamicMeshChangeInfo ChangeInfo) {
+            FComponentEntry* ChangedEntry = FindEntry(WeakComponent.Get());
+            const bool bMayChangeTopology = ChangeInfo.Type != EDynamicMeshChangeType::DeformationEdit &&
+                                            ChangeInfo.Type != EDynamicMeshChangeType::AttributeEdit &&
+                                            ChangeInfo.Type != EDynamicMeshChangeType::MeshVertexChange;
+            if (ChangedEntry && bMayChangeTopology) {
+                RebuildChunks(*ChangedEntry);
+            }
+        }
+    );
+}
+
+
+void URuntimeRenderChunkUpdater::RemoveComponent(UDynamicMeshComponent* Component) {
+    const int32 Index = Components.IndexOfByPredicate([Component](const FComponentEntry& Entry) {
+        return Entry.Component.Get() == Component;
+    });
+    if (Component == nullptr || Index == INDEX_NONE) {
+        return;
+    }
+
+    if (Component->GetDynamicMesh()) {
+        Component->GetDynamicMesh()->OnMeshChanged().Remove(Components[Index].MeshChangedHandle);
+    }
+    Components.RemoveAtSwap(Index);
+}
+
+
+void URuntimeRenderChunkUpdater::Tick() {
+    for (int32 k = Components.Num() - 1; k >= 0; --k) {
+        FComponentEntry& Entry = Components[k];
+        if (Entry.Component.IsValid() == false) {
+            Components.RemoveAtSwap(k);
+        } else if (HaveMaterialsChanged(Entry)) {
+            RebuildChunks(Entry);
+        }
+    }
+}
+
+
+URuntimeRenderChunkUpdater::FComponentEntry* URuntimeRenderChunkUpdater::FindEntry(UDynamicMeshComponent* Component) {
+    return Components.FindByPredicate([Component](const FComponentEntry& Entry) {
+        return Entry.Component.Get() == Component;
+    });
+}
+
+
+bool URuntimeRenderChunkUpdater::HaveMaterialsChanged(const FComponentEntry& Entry) const {
+    const UDynamicMeshComponent* Component = Entry.Component.Get();
+    if (Component == nullptr) {
+        return false;
+    }
+    if (Component->GetNumMaterials() != Entry.Materials.Num()) {
+        return true;
+    }
+    for (int32 k = 0; k < Entry.Materials.Num(); ++k) {
+        if (Component->GetMaterial(k) != Entry.Materials[k]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void URuntimeRenderChunkUpdater::RebuildChunks(FComponentEntry& Entry) {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_RenderChunksRebuild);
+
+    UDynamicMeshComponent* Component = Entry.Component.Get();
+    if (Component == nullptr) {
+        return;
+    }
+
+    FComponentMaterialSet MaterialSet;
+    for (int32 k = 0; k < Component->GetNumMaterials(); ++k) {
+        MaterialSet.Materials.Add(Component->GetMaterial(k));
+    }
+    Entry.Materials = MaterialSet.Materials;
+
+    const FDynamicMesh3* Mesh = Component->GetMesh();
+
+    // an empty mesh has no render proxy, the chunks are rebuilt with the next mesh change
+    if (Mesh->TriangleCount() == 0) {
+        return;
+    }
+
+    const int32 ChunkSize = FMath::Max(CVarRenderChunkSize.GetValueOnGameThread(), 1);
+    TUniquePtr<FMeshRenderDecomposition> Decomposition = MakeUnique<FMeshRenderDecomposition>();
+    FMeshRenderDecomposition::BuildChunkedDecomposition(Mesh, &MaterialSet, *Decomposition, ChunkSize);
+    Decomposition->BuildAssociations(Mesh);
+    Component->SetExternalDecomposition(MoveTemp(Decomposition));
+}
@@ -0,0 +1,114 @@
+#include "RuntimeToolsFramework/RuntimeToolComputeScheduler.h"
+#include "InteractiveTool.h"
+#include "MeshOpPreviewHelpers.h"
+#include "HAL/PlatformTime.h"
+
+
+int32 URuntimeToolComputeScheduler::RegisterCompute(
+    UInteractiveTool* Tool, UMeshOpPreviewWithBackgroundCompute* Preview
+) {
+    check(Tool && Preview);
+
+    FComputeEntry Entry;
+    Entry.Tool = Tool;
+    Entry.Preview = Preview;
+    // Tools generally kick off their first compute in Setup()
+    Entry.bRunning = (Preview->HaveValidResult() == false);
+
+    const int32 ComputeID = NextComputeID++;
+    Computes.Add(ComputeID, Entry);
+    return ComputeID;
+}
+
+
+void URuntimeToolComputeScheduler::UnregisterCompute(int32 ComputeID) {
+    Computes.Remove(ComputeID);
+}
+
+
+void URuntimeToolComputeScheduler::UnregisterTool(UInteractiveTool* Tool) {
+    for (auto It = Computes.CreateIterator(); It; ++It) {
+        if (It->Value.Tool.Get() == Tool || It->Value.Tool.IsValid() == false) {
+            It.RemoveCurrent();
+        }
+    }
+}
+
+
+void URuntimeToolComputeScheduler::RequestRecompute(int32 ComputeID) {
+    FComputeEntry* Entry = Computes.Find(ComputeID);
+    if (ensure(Entry != nullptr) && Entry->bPending == false) {
+        Entry->bPending = true;
+        Entry->RequestSerial = NextRequestSerial++;
+    }
+}
+
+
+void URuntimeToolComputeScheduler::TickCompute(int32 ComputeID, TFunctionRef<void()> TickFunc) {
+    // without a pending result, ticking the Preview only polls the background compute
+    const FComputeEntry* Entry = Computes.Find(ComputeID);
+    if (Entry == nullptr || Entry->bRunning == false) {
+        TickFunc();
+        return;
+    }
+
+    if (ResultDebtSeconds > 0.0) {
+        // out of budget, try again next frame
+        return;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    TickFunc();
+    ResultDebtSeconds += FPlatformTime::Seconds() - StartTime;
+}
+
+
+void URuntimeToolComputeScheduler::Tick(UInteractiveTool* ActiveTool) {
+    ResultDebtSeconds = FMath::Max(ResultDebtSeconds - ResultBudgetMs * 0.001, 0.0);
+
+    int32 NumRunning = 0;
+    TArray<int32, TInlineAllocator<8>> PendingIDs;
+    for (auto It = Computes.CreateIterator(); It; ++It) {
+        FComputeEntry& Entry = It->Value;
+        UMeshOpPreviewWithBackgroundCompute* Preview = Entry.Preview.Get();
+        if (Preview == nullptr || Entry.Tool.IsValid() == false) {
+            It.RemoveCurrent();
+            continue;
+        }
+
+        if (Entry.bRunning && Preview->HaveValidResult()) {
+            Entry.bRunning = false;
+        }
+
+        if (Entry.bPending && Entry.bRunning) {
+            // superseded, so restart it in the same slot
+            Preview->InvalidateResult();
+            Entry.bPending = false;
+        } else if (Entry.bPending) {
+            PendingIDs.Add(It->Key);
+        }
+        NumRunning += Entry.bRunning ? 1 : 0;
+    }
+
+    PendingIDs.Sort([this, ActiveTool](int32 A, int32 B) {
+        const FComputeEntry& EntryA = Computes[A];
+        const FComputeEntry& EntryB = Computes[B];
+        const bool bActiveA = (EntryA.Tool.Get() == ActiveTool);
+        const bool bActiveB = (EntryB.Tool.Get() == ActiveTool);
+        if (bActiveA != bActiveB) {
+            return bActiveA;
+        }
+        return EntryA.RequestSerial < EntryB.RequestSerial;
+    });
+
+    for (int32 ComputeID : PendingIDs) {
+        if (NumRunning >= FMath::Max(1, MaxConcurrentComputes)) {
+            break;
+        }
+        FComputeEntry& Entry = Computes[ComputeID];
+        Entry.Preview->InvalidateResult();
+        Entry.bPending = false;
+        Entry.bRunning = true;
+        NumRunning++;
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// `stat RuntimeTools`
+DECLARE_STATS_GROUP(TEXT("RuntimeTools"), STATGROUP_RuntimeTools, STATCAT_Advanced);
+
+// Cycle counter scope for a stat declared with DECLARE_CYCLE_STAT(..., STATGROUP_RuntimeTools). Cycle counters also
+// emit Unreal Insights CPU events, so in builds without stats this falls back to a plain trace scope of the same name.
+#if STATS
+#define RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(Stat) SCOPE_CYCLE_COUNTER(Stat)
+#else
+#define RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(Stat) TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+#endif
@@ -1,13 +1,48 @@
 #include "Tools/RuntimeDynamicMeshSculptTool.h"
+#include "Tools/RuntimeSculptBrushKernels.h"
 #include "ToolsSubsystem.h"
+#include "RuntimeToolsFramework/RuntimeDynamicMeshComponentToolTarget.h"
+#include "RuntimeToolsStats.h"
 
 #include "ToolBuilderUtil.h"
+#include "ModelingToolTargetUtil.h"
+#include "Components/OctreeDynamicMeshComponent.h"
+#include "Components/DynamicMeshComponent.h"
+#include "DynamicMesh/MeshNormals.h"
+#include "DynamicMesh/MeshWeights.h"
+#include "MeshQueries.h"
+#include "SubRegionRemesher.h"
+#include "Algo/Unique.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+using namespace UE::Geometry;
 
 #define LOCTEXT_NAMESPACE "URuntimeDynamicMeshSculptTool"
 
+DECLARE_CYCLE_STAT(TEXT("Sculpt Stamp"), STAT_RuntimeTools_SculptStamp, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("Sculpt Stamp ROI"), STAT_RuntimeTools_SculptStampROI, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("Sculpt Stamp Normals"), STAT_RuntimeTools_SculptStampNormals, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("Sculpt Stamp Render Update"), STAT_RuntimeTools_SculptStampRender, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("Sculpt Remesh"), STAT_RuntimeTools_SculptRemesh, STATGROUP_RuntimeTools);
+
+static TAutoConsoleVariable<bool> CVarSculptVectorizedKernels(
+    TEXT("RuntimeTools.SculptVectorizedKernels"), true,
+    TEXT("Evaluate the brush stamps of URuntimeDynamicMeshSculptTool with the vectorized kernels (otherwise one "
+         "vertex at a time).")
+);
+
+static TAutoConsoleVariable<bool> CVarSculptFalloffTable(
+    TEXT("RuntimeTools.SculptFalloffTable"), false,
+    TEXT("Look up the brush falloff of URuntimeDynamicMeshSculptTool stamps in a table rather than computing it for "
+         "every vertex. Faster, but only approximates the falloff curve.")
+);
+
 UMeshSurfacePointTool* URuntimeDynamicMeshSculptToolBuilder::CreateNewTool(const FToolBuilderState& SceneState) const {
     URuntimeDynamicMeshSculptTool* SculptTool = NewObject<URuntimeDynamicMeshSculptTool>(SceneState.ToolManager);
     SculptTool->SetEnableRemeshing(this->bEnableRemeshing);
+    SculptTool->bRemeshingEnabled = this->bEnableRemeshing;
     SculptTool->SetWorld(SceneState.World);
     return SculptTool;
 }
@@ -34,12 +69,67 @@ static EDynamicMeshSculptBrushType Convert(ERuntimeDynamicMeshSculptBrushType Br
 }
 
 
+namespace RuntimeSculptLocals {
+
+// @return true if strokes of the given brush type are applied by URuntimeDynamicMeshSculptTool::ApplyStamp()
+static bool IsRuntimeBrushType(EDynamicMeshSculptBrushType BrushType) {
+    return BrushType == EDynamicMeshSculptBrushType::Move || BrushType == EDynamicMeshSculptBrushType::Offset ||
+           BrushType == EDynamicMeshSculptBrushType::Smooth || BrushType == EDynamicMeshSculptBrushType::Inflate ||
+           BrushType == EDynamicMeshSculptBrushType::PlaneViewAligned;
+}
+
+// number of remesh passes run over the region of every stamp
+static constexpr int32 RemeshPassesPerRegion = 5;
+
+// append the triangles of Vertices to Triangles, once each. Markers must be clear, and is cleared again on return.
+static void CollectVertexTriangles(
+    const FDynamicMesh3& Mesh, TArrayView<const int32> Vertices, TBitArray<>& Markers, TArray<int32>& Triangles
+) {
+    const int32 StartNum = Triangles.Num();
+    Markers.SetNum(Mesh.MaxTriangleID(), false);
+    for (int32 VertexID : Vertices) {
+        Mesh.EnumerateVertexTriangles(VertexID, [&](int32 TriangleID) {
+            if (Markers[TriangleID] == false) {
+                Markers[TriangleID] = true;
+                Triangles.Add(TriangleID);
+            }
+        });
+    }
+    for (int32 k = StartNum; k < Triangles.Num(); ++k) {
+        Markers[Triangles[k]] = false;
+    }
+}
+
+}  // namespace RuntimeSculptLocals
+
+
 void URuntimeDynamicMeshSculptTool::Setup() {
     UDynamicMeshSculptTool::Setup();
 
+    // the UDynamicMeshSculptTool creates its Component on the target Actor
+    AActor* TargetActor = UE::ToolTarget::GetTargetActor(Target);
+    SculptComponent = TargetActor ? TargetActor->FindComponentByClass<UOctreeDynamicMeshComponent>() : nullptr;
+
+    // CommitTouchedVertices() checks that the target did not change since, which only needs to read it
+    if (URuntimeDynamicMeshComponentToolTarget* RuntimeTarget = Cast<URuntimeDynamicMeshComponentToolTarget>(Target)) {
+        RuntimeTarget->ProcessReadOnlyMesh([this](const FDynamicMesh3& TargetMesh) {
+            SetupMaxVertexID = TargetMesh.MaxVertexID();
+            SetupMaxTriangleID = TargetMesh.MaxTriangleID();
+        });
+    }
+
     // mirror properties we want to expose at runtime
     RuntimeProperties = NewObject<URuntimeDynamicMeshSculptToolProperties>(this);
 
+    if (SculptComponent && bRemeshingEnabled) {
+        // remesh towards the current resolution of the mesh, unless set otherwise
+        double MinEdgeLength, MaxEdgeLength, AvgEdgeLength;
+        TMeshQueries<FDynamicMesh3>::EdgeLengthStats(
+            *SculptComponent->GetMesh(), MinEdgeLength, MaxEdgeLength, AvgEdgeLength
+        );
+        RuntimeProperties->RemeshTargetEdgeLength = static_cast<float>(AvgEdgeLength);
+    }
+
     RuntimeProperties->BrushSize = BrushProperties->BrushSize.AdaptiveSize;
     RuntimeProperties->WatchProperty(RuntimeProperties->BrushSize, [this](float NewValue) {
         BrushProperties->BrushSize.AdaptiveSize = NewValue;
@@ -68,4 +158,765 @@ void URuntimeDynamicMeshSculptTool::Setup() {
 }
 
 
-#undef LOCTEXT_NAMESPACE
\ No newline at end of file
+void URuntimeDynamicMeshSculptTool::Shutdown(EToolShutdownType ShutdownType) {
+    if (bInStroke) {
+        EndStroke();
+    }
+    if (ShutdownType == EToolShutdownType::Accept) {
+        FinishPendingRemesh();
+    } else {
+        RemeshQueue.Reset();
+        TopologyChangeTracker.Reset();
+    }
+
+    // the UDynamicMeshSculptTool commits the whole mesh, so it only gets to if the result cannot be committed here
+    if (ShutdownType == EToolShutdownType::Accept && CommitTouchedVertices()) {
+        ShutdownType = EToolShutdownType::Cancel;
+    }
+
+    UDynamicMeshSculptTool::Shutdown(ShutdownType);
+
+    // the UDynamicMeshSculptTool destroyed it, which also expires the FRuntimeSculptStrokeChanges of this tool
+    SculptComponent = nullptr;
+}
+
+
+void URuntimeDynamicMeshSculptTool::OnTick(float DeltaTime) {
+    UDynamicMeshSculptTool::OnTick(DeltaTime);
+
+    if (bInStroke && bStampPending) {
+        ApplyStamp(PendingStampRay);
+        bStampPending = false;
+    }
+
+    if (RemeshQueue.Num() > 0) {
+        ProcessRemeshQueue(RuntimeProperties->RemeshTimeBudgetMs * 0.001);
+    }
+    if (TopologyChangeTracker.IsValid() && bInStroke == false && RemeshQueue.Num() == 0) {
+        EmitTopologyChange(LOCTEXT("SculptRemeshChange", "Remesh"));
+    }
+}
+
+
+void URuntimeDynamicMeshSculptTool::OnBeginDrag(const FRay& Ray) {
+    // shift-drag smooths, like in the UDynamicMeshSculptTool
+    const EDynamicMeshSculptBrushType BrushType =
+        GetShiftToggle() ? EDynamicMeshSculptBrushType::Smooth : SculptProperties->PrimaryBrushType;
+    if (SculptComponent == nullptr || bApplyRuntimeStamps == false ||
+        RuntimeSculptLocals::IsRuntimeBrushType(BrushType) == false) {
+        // the stroke can move any vertex (or remesh), so the result has to be committed by the UDynamicMeshSculptTool
+        bCommitTouchedVertices = false;
+        if (SculptComponent) {
+            FinishPendingRemesh();
+        }
+        UDynamicMeshSculptTool::OnBeginDrag(Ray);
+        return;
+    }
+
+    // HitTest() is implemented by the UDynamicMeshSculptTool, against the same octree ApplyStamp() updates
+    FHitResult Hit;
+    if (HitTest(Ray, Hit) == false) {
+        return;
+    }
+
+    FViewCameraState CameraState;
+    GetToolManager()->GetContextQueriesAPI()->GetCurrentViewState(CameraState);
+
+    StrokeBrushType = Convert(BrushType);
+    bInvertStroke = GetCtrlToggle();
+    StrokeTransform = FTransformSRT3d(SculptComponent->GetComponentTransform());
+    LastBrushPosLocal = StrokeTransform.InverseTransformPosition(FVector3d(Hit.ImpactPoint));
+    const FVector3d ViewNormal = StrokeTransform.InverseTransformVector(-FVector3d(CameraState.Forward()));
+    StrokePlane = FFrame3d(LastBrushPosLocal, Normalized(ViewNormal));
+
+    ActiveStrokeChange = MakeUnique<FRuntimeSculptStrokeChange>();
+    if (bRemeshingEnabled) {
+        // remeshing that is still queued from the previous stroke is recorded along with this one from here on
+        if (TopologyChangeTracker.IsValid()) {
+            EmitTopologyChange(LOCTEXT("SculptRemeshChange", "Remesh"));
+        }
+        BeginTopologyChange();
+    }
+    bInStroke = true;
+
+    // the Move brush only moves vertices once the ray moves away from the start position
+    PendingStampRay = Ray;
+    bStampPending = (StrokeBrushType != ERuntimeDynamicMeshSculptBrushType::Move);
+}
+
+
+void URuntimeDynamicMeshSculptTool::OnUpdateDrag(const FRay& Ray) {
+    if (bInStroke == false) {
+        UDynamicMeshSculptTool::OnUpdateDrag(Ray);
+        return;
+    }
+
+    PendingStampRay = Ray;
+    bStampPending = true;
+
+    // the brush indicator is only updated on hover by the UDynamicMeshSculptTool, so move it along explicitly
+    if (StrokeBrushType != ERuntimeDynamicMeshSculptBrushType::Move) {
+        OnUpdateHover(FInputDeviceRay(Ray));
+    }
+}
+
+
+void URuntimeDynamicMeshSculptTool::OnEndDrag(const FRay& Ray) {
+    if (bInStroke == false) {
+        UDynamicMeshSculptTool::OnEndDrag(Ray);
+        return;
+    }
+
+    if (bStampPending) {
+        ApplyStamp(PendingStampRay);
+        bStampPending = false;
+    }
+    EndStroke();
+}
+
+
+void URuntimeDynamicMeshSculptTool::EndStroke() {
+    if (ActiveStrokeChange.IsValid()) {
+        for (int32 VertexID : ActiveStrokeChange->Vertices) {
+            StrokeVertexMarkers[VertexID] = false;
+        }
+        if (ActiveStrokeChange->Vertices.Num() > 0) {
+            GetToolManager()->EmitObjectChange(
+                this, MoveTemp(ActiveStrokeChange), LOCTEXT("SculptStrokeChange", "Brush Stroke")
+            );
+        }
+    }
+    ActiveStrokeChange.Reset();
+
+    if (TopologyChangeTracker.IsValid()) {
+        EmitTopologyChange(LOCTEXT("SculptStrokeChange", "Brush Stroke"));
+        if (RemeshQueue.Num() > 0) {
+            BeginTopologyChange();
+        }
+    }
+    bInStroke = false;
+}
+
+
+void URuntimeDynamicMeshSculptTool::QueueRemesh(TArrayView<const int32> Vertices) {
+    const FDynamicMesh3* Mesh = SculptComponent->GetMesh();
+
+    // vertices that are queued already get their passes from the earlier region
+    FRemeshRegion Region;
+    Region.PassesLeft = RuntimeSculptLocals::RemeshPassesPerRegion;
+    RemeshQueueVertexMarkers.SetNum(Mesh->MaxVertexID(), false);
+    for (int32 VertexID : Vertices) {
+        if (Mesh->IsVertex(VertexID) && RemeshQueueVertexMarkers[VertexID] == false) {
+            RemeshQueueVertexMarkers[VertexID] = true;
+            Region.Vertices.Add(VertexID);
+        }
+    }
+    if (Region.Vertices.Num() > 0) {
+        RemeshQueue.Add(MoveTemp(Region));
+    }
+
+    if (RuntimeProperties->RemeshTimeBudgetMs <= 0) {
+        ProcessRemeshQueue(-1.0);
+    }
+}
+
+
+void URuntimeDynamicMeshSculptTool::ProcessRemeshQueue(double TimeBudgetSeconds) {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_SculptRemesh);
+
+    if (RemeshQueue.Num() == 0) {
+        return;
+    }
+
+    // one pass per region at a time, so that all queued regions make progress
+    const double StartTime = FPlatformTime::Seconds();
+    do {
+        FRemeshRegion Region = MoveTemp(RemeshQueue[0]);
+        RemeshQueue.RemoveAt(0);
+        RemeshRegion(Region);
+        if (--Region.PassesLeft > 0 && Region.Vertices.Num() > 0) {
+            RemeshQueue.Add(MoveTemp(Region));
+        }
+    } while (RemeshQueue.Num() > 0 &&
+             (TimeBudgetSeconds < 0 || FPlatformTime::Seconds() - StartTime < TimeBudgetSeconds));
+
+    SculptComponent->NotifyMeshUpdated();
+}
+
+
+void URuntimeDynamicMeshSculptTool::RemeshRegion(FRemeshRegion& Region) {
+    FDynamicMesh3* Mesh = SculptComponent->GetMesh();
+    FDynamicMeshOctree3* Octree = SculptComponent->GetOctree();
+
+    // earlier passes over other regions may have collapsed some of the vertices
+    FSubRegionRemesher Remesher(Mesh);
+    for (int32 VertexID : Region.Vertices) {
+        RemeshQueueVertexMarkers[VertexID] = false;
+        if (Mesh->IsVertex(VertexID)) {
+            Remesher.VertexROI.Add(VertexID);
+        }
+    }
+    Region.Vertices.Reset();
+    if (Remesher.VertexROI.Num() == 0) {
+        return;
+    }
+
+    Remesher.SetTargetEdgeLength(FMathd::Max(RuntimeProperties->RemeshTargetEdgeLength, FMathd::ZeroTolerance));
+    Remesher.SmoothSpeedT = RemeshProperties->SmoothingStrength;
+    Remesher.bEnableFlips = RemeshProperties->bFlips;
+    Remesher.bEnableSplits = RemeshProperties->bSplits;
+    Remesher.bEnableCollapses = RemeshProperties->bCollapses;
+    Remesher.bPreventNormalFlips = RemeshProperties->bPreventNormalFlips;
+    Remesher.InitializeFromVertexROI();
+    Remesher.SetMeshChangeTracker(TopologyChangeTracker.Get());
+
+    // the triangles of the region are taken out of the octree, and the ones it ends up with are inserted again
+    TArray<int32> Triangles = Remesher.GetCurrentTriangleROI().Array();
+    TopologyChangeTracker->SaveTriangles(Triangles, true);
+    Octree->RemoveTriangles(Triangles);
+
+    Remesher.BasicRemeshPass();
+
+    Triangles.Reset();
+    for (int32 TriangleID : Remesher.GetCurrentTriangleROI()) {
+        if (Mesh->IsTriangle(TriangleID)) {
+            Triangles.Add(TriangleID);
+        }
+    }
+    Octree->InsertTriangles(Triangles);
+    TArray<int32> NormalElements;
+    UpdateNormals(*Mesh, Triangles, NormalElements);
+
+    // the next pass covers the region as it is now
+    RemeshQueueVertexMarkers.SetNum(Mesh->MaxVertexID(), false);
+    for (int32 VertexID : Remesher.VertexROI) {
+        if (Mesh->IsVertex(VertexID) && RemeshQueueVertexMarkers[VertexID] == false) {
+            RemeshQueueVertexMarkers[VertexID] = true;
+            Region.Vertices.Add(VertexID);
+        }
+    }
+}
+
+
+void URuntimeDynamicMeshSculptTool::BeginTopologyChange() {
+    if (TopologyChangeTracker.IsValid() == false) {
+        TopologyChangeTracker = MakeUnique<FDynamicMeshChangeTracker>(SculptComponent->GetMesh());
+        TopologyChangeTracker->BeginChange();
+    }
+}
+
+
+void URuntimeDynamicMeshSculptTool::EmitTopologyChange(const FText& ChangeMessage) {
+    TUniquePtr<FRuntimeSculptStrokeChange> Change = MakeUnique<FRuntimeSculptStrokeChange>();
+    Change->TopologyChange = MakeShared<FMeshChange>(TopologyChangeTracker->EndChange());
+    TopologyChangeTracker.Reset();
+    AppliedTopologyChanges.Add(Change->TopologyChange);
+    GetToolManager()->EmitObjectChange(this, MoveTemp(Change), ChangeMessage);
+}
+
+
+void URuntimeDynamicMeshSculptTool::FinishPendingRemesh() {
+    ProcessRemeshQueue(-1.0);
+    if (TopologyChangeTracker.IsValid()) {
+        EmitTopologyChange(LOCTEXT("SculptRemeshChange", "Remesh"));
+    }
+}
+
+
+void URuntimeDynamicMeshSculptTool::CancelPendingRemesh(TArray<int32>& RegionVertices) {
+    for (const FRemeshRegion& Region : RemeshQueue) {
+        RegionVertices.Append(Region.Vertices);
+    }
+    RemeshQueue.Reset();
+    RemeshQueueVertexMarkers.Reset();
+    if (TopologyChangeTracker.IsValid()) {
+        FMeshChange PendingChange(TopologyChangeTracker->EndChange());
+        TopologyChangeTracker.Reset();
+        SculptComponent->ApplyChange(&PendingChange, true);
+
+        // the reverted remeshing covered the saved triangles, which are back now
+        const FDynamicMesh3* Mesh = SculptComponent->GetMesh();
+        TArray<int32> Triangles;
+        PendingChange.DynamicMeshChange->GetSavedTriangleList(Triangles, true);
+        for (int32 TriangleID : Triangles) {
+            if (Mesh->IsTriangle(TriangleID)) {
+                const FIndex3i Triangle = Mesh->GetTriangle(TriangleID);
+                RegionVertices.Append({Triangle.A, Triangle.B, Triangle.C});
+            }
+        }
+    }
+}
+
+
+void URuntimeDynamicMeshSculptTool::ApplyStrokeChange(FRuntimeSculptStrokeChange& Change, bool bRevert) {
+    // the change was made on the mesh from before the remeshing that is still pending, which is queued again for the
+    // mesh after the change. Its recorded change then replaces the redo history, as for any new edit.
+    TArray<int32> PendingRemeshVertices;
+    CancelPendingRemesh(PendingRemeshVertices);
+
+    if (Change.TopologyChange.IsValid()) {
+        // updates the octree and the SculptComponent render buffers
+        SculptComponent->ApplyChange(Change.TopologyChange.Get(), bRevert);
+        if (bRevert == false) {
+            AppliedTopologyChanges.Add(Change.TopologyChange);
+        } else if (AppliedTopologyChanges.Num() > 0 && AppliedTopologyChanges.Last() == Change.TopologyChange) {
+            AppliedTopologyChanges.Pop();
+        } else {
+            // not the most recent change, so the applied changes cannot be replayed in order anymore
+            bCommitTouchedVertices = false;
+        }
+    } else {
+        Change.SwapPositions(*SculptComponent->GetMesh());
+        StampVertices = Change.Vertices;
+        UpdateStampVertices();
+    }
+
+    if (PendingRemeshVertices.Num() > 0) {
+        BeginTopologyChange();
+        QueueRemesh(PendingRemeshVertices);
+    }
+}
+
+
+bool URuntimeDynamicMeshSculptTool::CommitTouchedVertices() {
+    using namespace RuntimeSculptLocals;
+
+    URuntimeDynamicMeshComponentToolTarget* RuntimeTarget = Cast<URuntimeDynamicMeshComponentToolTarget>(Target);
+    UDynamicMeshComponent* TargetComponent = RuntimeTarget ? RuntimeTarget->GetDynamicMeshComponent() : nullptr;
+    if (bCommitTouchedVertices == false || TargetComponent == nullptr || SculptComponent == nullptr) {
+        return false;
+    }
+    const bool bTopologyChanged = (AppliedTopologyChanges.Num() > 0);
+    if (TouchedVertices.Num() == 0 && bTopologyChanged == false) {
+        return true;
+    }
+
+    // triangles of the target that the commit modifies or removes: the ones the topology changes start from (those
+    // that were added by earlier changes do not exist in the target yet), and the ones around the touched vertices
+    const FDynamicMesh3* SculptMesh = SculptComponent->GetMesh();
+    bool bSameMesh = false;
+    TArray<int32> Triangles;
+    TArray<int32> InitialChangeTriangles;
+    TArray<int32> ChangeTriangles;
+    RuntimeTarget->ProcessReadOnlyMesh([&](const FDynamicMesh3& TargetMesh) {
+        bSameMesh = (TargetMesh.MaxVertexID() == SetupMaxVertexID && TargetMesh.MaxTriangleID() == SetupMaxTriangleID);
+        if (bSameMesh == false) {
+            return;
+        }
+        for (const TSharedPtr<const FMeshChange>& Change : AppliedTopologyChanges) {
+            ChangeTriangles.Reset();
+            Change->DynamicMeshChange->GetSavedTriangleList(ChangeTriangles, true);
+            for (int32 TriangleID : ChangeTriangles) {
+                if (TargetMesh.IsTriangle(TriangleID)) {
+                    InitialChangeTriangles.Add(TriangleID);
+                }
+            }
+        }
+        Triangles = InitialChangeTriangles;
+        for (int32 VertexID : TouchedVertices) {
+            if (TargetMesh.IsVertex(VertexID)) {
+                TargetMesh.EnumerateVertexTriangles(VertexID, [&](int32 TriangleID) { Triangles.Add(TriangleID); });
+            }
+        }
+    });
+    if (bSameMesh == false) {
+        return false;
+    }
+    Triangles.Sort();
+    Triangles.SetNum(Algo::Unique(Triangles));
+
+    // the sculpt mesh is a copy of the target mesh with the same IDs, but not necessarily in the same space
+    const FTransformSRT3d SculptToWorld(SculptComponent->GetComponentTransform());
+    const FTransformSRT3d TargetToWorld(TargetComponent->GetComponentTransform());
+
+    GetToolManager()->BeginUndoTransaction(LOCTEXT("SculptMeshToolTransactionName", "Sculpt Mesh"));
+    RuntimeTarget->CommitMeshRegion(
+        Triangles,
+        [&](FDynamicMesh3& EditMesh) {
+            // Replaying the changes gives the target the topology (and IDs) of the sculpt mesh, but with positions in
+            // the space of the sculpt mesh. So the positions of all vertices in the changed region are set afterwards.
+            TArray<int32> Vertices;
+            TArray<int32> EditTriangles;
+            for (int32 TriangleID : InitialChangeTriangles) {
+                const FIndex3i Triangle = EditMesh.GetTriangle(TriangleID);
+                Vertices.Append({Triangle.A, Triangle.B, Triangle.C});
+            }
+            for (const TSharedPtr<const FMeshChange>& Change : AppliedTopologyChanges) {
+                Change->ApplyChangeToMesh(&EditMesh, false);
+            }
+            for (const TSharedPtr<const FMeshChange>& Change : AppliedTopologyChanges) {
+                ChangeTriangles.Reset();
+                Change->DynamicMeshChange->GetSavedTriangleList(ChangeTriangles, false);
+                for (int32 TriangleID : ChangeTriangles) {
+                    if (EditMesh.IsTriangle(TriangleID)) {
+                        const FIndex3i Triangle = EditMesh.GetTriangle(TriangleID);
+                        Vertices.Append({Triangle.A, Triangle.B, Triangle.C});
+                    }
+                }
+            }
+            Vertices.Append(TouchedVertices);
+            Vertices.Sort();
+            Vertices.SetNum(Algo::Unique(Vertices));
+            Vertices.RemoveAll([&](int32 VertexID) {
+                return EditMesh.IsVertex(VertexID) == false || SculptMesh->IsVertex(VertexID) == false;
+            });
+
+            ParallelForStampRanges(Vertices.Num(), [&](int32 Start, int32 End) {
+                for (int32 k = Start; k < End; ++k) {
+                    const FVector3d WorldPos = SculptToWorld.TransformPosition(SculptMesh->GetVertex(Vertices[k]));
+                    EditMesh.SetVertex(Vertices[k], TargetToWorld.InverseTransformPosition(WorldPos), false);
+                }
+            });
+            EditMesh.UpdateChangeStamps(true, false);
+
+            CollectVertexTriangles(EditMesh, Vertices, TriangleMarkers, EditTriangles);
+            TArray<int32> NormalElements;
+            UpdateNormals(EditMesh, EditTriangles, NormalElements);
+        },
+        bTopologyChanged, LOCTEXT("SculptMeshChange", "Sculpt Mesh")
+    );
+    GetToolManager()->EndUndoTransaction();
+    return true;
+}
+
+
+void URuntimeDynamicMeshSculptTool::ParallelForStampRanges(
+    int32 Num, TFunctionRef<void(int32 Start, int32 End)> RangeFunc
+) const {
+    int32 NumTasks = 1;
+    if (RuntimeProperties->bParallelStamps) {
+        const int32 MaxTasks = (RuntimeProperties->MaxStampTasks > 0)
+                                   ? RuntimeProperties->MaxStampTasks
+                                   : FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+        NumTasks = FMath::Clamp(Num / FMath::Max(RuntimeProperties->MinStampTaskVertices, 1), 1, MaxTasks);
+    }
+
+    const int32 TaskSize = FMath::DivideAndRoundUp(Num, NumTasks);
+    ParallelFor(
+        NumTasks, [&](int32 Task) { RangeFunc(Task * TaskSize, FMath::Min((Task + 1) * TaskSize, Num)); },
+        (NumTasks > 1) ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread
+    );
+}
+
+
+RuntimeSculptBrushKernels::FStampKernel FRuntimeSculptStamp::MakeKernel() const {
+    using FStampKernel = RuntimeSculptBrushKernels::FStampKernel;
+    const double OffsetSpeed = (bInvert ? -1.0 : 1.0) * FMathd::Sqrt(Radius) * PrimarySpeed;
+
+    FStampKernel Kernel;
+    Kernel.BrushPos = BrushPos;
+    Kernel.Radius = Radius;
+    Kernel.FalloffAmount = FalloffAmount;
+    switch (BrushType) {
+        case ERuntimeDynamicMeshSculptBrushType::Move:
+            Kernel.Speed = 1.0;
+            Kernel.Direction = MoveDelta;
+            break;
+        case ERuntimeDynamicMeshSculptBrushType::Sculpt:
+            Kernel.Speed = OffsetSpeed;
+            Kernel.Direction = BrushNormal;
+            break;
+        case ERuntimeDynamicMeshSculptBrushType::Inflate:
+            Kernel.DirectionType = FStampKernel::EDirection::PerVertex;
+            Kernel.Speed = OffsetSpeed;
+            break;
+        case ERuntimeDynamicMeshSculptBrushType::Smooth:
+            // the UDynamicMeshSculptTool smooths with its own speed, also for shift-smoothing during other brushes
+            Kernel.DirectionType = FStampKernel::EDirection::ToTarget;
+            Kernel.Speed = FMathd::Clamp(SmoothSpeed, 0.0, 1.0);
+            break;
+        case ERuntimeDynamicMeshSculptBrushType::Flatten:
+            Kernel.DirectionType = FStampKernel::EDirection::ToPlane;
+            Kernel.Speed = FMathd::Clamp(PrimarySpeed, 0.0, 1.0);
+            Kernel.Direction = StrokePlane.Z();
+            Kernel.PlaneOrigin = StrokePlane.Origin;
+            break;
+    }
+    return Kernel;
+}
+
+
+FVector3d FRuntimeSculptStamp::GetVertexVector(const FDynamicMesh3& Mesh, int32 VertexID) const {
+    switch (BrushType) {
+        case ERuntimeDynamicMeshSculptBrushType::Inflate:
+            return FMeshNormals::ComputeVertexNormal(Mesh, VertexID);
+        case ERuntimeDynamicMeshSculptBrushType::Smooth:
+            // mean-value weights keep the vertices from sliding along the surface, which would distort the UVs
+            return bPreserveUVFlow ? FMeshWeights::MeanValueCentroid(Mesh, VertexID)
+                                   : FMeshWeights::UniformCentroid(Mesh, VertexID);
+        default:
+            return FVector3d::Zero();
+    }
+}
+
+
+bool URuntimeDynamicMeshSculptTool::ApplyStamp(const FRay& WorldRay) {
+    using namespace RuntimeSculptLocals;
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_SculptStamp);
+
+    FDynamicMesh3* Mesh = SculptComponent->GetMesh();
+    FDynamicMeshOctree3* Octree = SculptComponent->GetOctree();
+    const FRay3d LocalRay(
+        StrokeTransform.InverseTransformPosition(FVector3d(WorldRay.Origin)),
+        Normalized(StrokeTransform.InverseTransformVector(FVector3d(WorldRay.Direction)))
+    );
+
+    //
+    // brush position
+    //
+
+    FVector3d BrushPos = LastBrushPosLocal;
+    FVector3d BrushNormal = FVector3d::UnitZ();
+    FVector3d MoveDelta = FVector3d::Zero();
+    if (StrokeBrushType == ERuntimeDynamicMeshSculptBrushType::Move) {
+        // drag the vertices around the previous position along with the ray, in the view plane
+        FVector3d PlaneHit;
+        if (StrokePlane.RayPlaneIntersection(LocalRay.Origin, LocalRay.Direction, 2, PlaneHit) == false) {
+            return false;
+        }
+        MoveDelta = PlaneHit - LastBrushPosLocal;
+        LastBrushPosLocal = PlaneHit;
+    } else {
+        const int32 HitTriangleID = Octree->FindNearestHitObject(LocalRay);
+        if (HitTriangleID == IndexConstants::InvalidID) {
+            return false;
+        }
+        const FIntrRay3Triangle3d Intersection =
+            TMeshQueries<FDynamicMesh3>::TriangleIntersection(*Mesh, HitTriangleID, LocalRay);
+        BrushPos = LocalRay.PointAt(Intersection.RayParameter);
+        BrushNormal = Mesh->GetTriNormal(HitTriangleID);
+        LastBrushPosLocal = BrushPos;
+    }
+
+    const double Radius = BrushProperties->BrushSize.GetWorldRadius() / StrokeTransform.GetScale().GetMax();
+    const double FalloffAmount = BrushProperties->BrushFalloffAmount;
+
+    //
+    // vertex ROI
+    //
+
+    {
+        RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_SculptStampROI);
+
+        const FAxisAlignedBox3d BrushBox(BrushPos - Radius * FVector3d::One(), BrushPos + Radius * FVector3d::One());
+        RangeQueryTriangles.Reset();
+        Octree->ParallelRangeQuery(BrushBox, RangeQueryTriangles);
+
+        // unique vertices of the range query triangles that are within the brush radius
+        VertexMarkers.SetNum(Mesh->MaxVertexID(), false);
+        StampVertices.Reset();
+        const double RadiusSqr = Radius * Radius;
+        for (int32 TriangleID : RangeQueryTriangles) {
+            const FIndex3i Triangle = Mesh->GetTriangle(TriangleID);
+            for (int32 j = 0; j < 3; ++j) {
+                if (VertexMarkers[Triangle[j]] == false) {
+                    VertexMarkers[Triangle[j]] = true;
+                    if (DistanceSquared(Mesh->GetVertex(Triangle[j]), BrushPos) < RadiusSqr) {
+                        StampVertices.Add(Triangle[j]);
+                    }
+                }
+            }
+        }
+        for (int32 TriangleID : RangeQueryTriangles) {
+            const FIndex3i Triangle = Mesh->GetTriangle(TriangleID);
+            VertexMarkers[Triangle.A] = VertexMarkers[Triangle.B] = VertexMarkers[Triangle.C] = false;
+        }
+
+        // the range query order depends on the threads, so sort by distance and vertex ID to keep the budget
+        // deterministic
+        const int32 MaxStampVertices = RuntimeProperties->MaxStampVertices;
+        if (MaxStampVertices > 0 && StampVertices.Num() > MaxStampVertices) {
+            StampVertices.Sort([&](int32 A, int32 B) {
+                const double DistA = DistanceSquared(Mesh->GetVertex(A), BrushPos);
+                const double DistB = DistanceSquared(Mesh->GetVertex(B), BrushPos);
+                return DistA < DistB || (DistA == DistB && A < B);
+            });
+            StampVertices.SetNum(MaxStampVertices, false);
+        }
+    }
+
+    const int32 NumVertices = StampVertices.Num();
+    if (NumVertices == 0) {
+        return true;
+    }
+
+    //
+    // evaluate the new positions. Only reads the current positions, so the ranges can be evaluated in any order.
+    //
+
+    const bool bFalloffTable = CVarSculptFalloffTable.GetValueOnGameThread();
+    if (bFalloffTable) {
+        // updated here, as the falloff amount can also be changed through the UDynamicMeshSculptTool properties
+        FalloffTable.Update(FalloffAmount);
+    }
+
+    FRuntimeSculptStamp Stamp;
+    Stamp.BrushType = StrokeBrushType;
+    Stamp.BrushPos = BrushPos;
+    Stamp.Radius = Radius;
+    Stamp.FalloffAmount = FalloffAmount;
+    Stamp.bInvert = bInvertStroke;
+    Stamp.PrimarySpeed = SculptProperties->PrimaryBrushSpeed;
+    Stamp.SmoothSpeed = SculptProperties->SmoothBrushSpeed;
+    Stamp.bPreserveUVFlow = SculptProperties->bPreserveUVFlow;
+    Stamp.BrushNormal = BrushNormal;
+    Stamp.MoveDelta = MoveDelta;
+    Stamp.StrokePlane = StrokePlane;
+
+    using FStampKernel = RuntimeSculptBrushKernels::FStampKernel;
+    const FStampKernel Kernel = Stamp.MakeKernel();
+    const bool bVertexVectors = (Kernel.DirectionType == FStampKernel::EDirection::PerVertex ||
+                                 Kernel.DirectionType == FStampKernel::EDirection::ToTarget);
+    const bool bVectorized = CVarSculptVectorizedKernels.GetValueOnGameThread();
+
+    StampPositions.SetNumUninitialized(NumVertices, false);
+    StampVertexVectors.SetNumUninitialized(bVertexVectors ? NumVertices : 0, false);
+    ParallelForStampRanges(NumVertices, [&](int32 Start, int32 End) {
+        // the per-vertex inputs need mesh queries, so they are gathered first
+        for (int32 k = Start; k < End; ++k) {
+            const int32 VertexID = StampVertices[k];
+            StampPositions[k] = Mesh->GetVertex(VertexID);
+            if (bVertexVectors) {
+                StampVertexVectors[k] = Stamp.GetVertexVector(*Mesh, VertexID);
+            }
+        }
+
+        TArrayView<FVector3d> Positions = TArrayView<FVector3d>(StampPositions).Slice(Start, End - Start);
+        TArrayView<const FVector3d> VertexVectors =
+            bVertexVectors ? TArrayView<const FVector3d>(StampVertexVectors).Slice(Start, End - Start)
+                           : TArrayView<const FVector3d>();
+        RuntimeSculptBrushKernels::EvaluateStamp(
+            Kernel, bFalloffTable ? &FalloffTable : nullptr, Positions, VertexVectors, Positions, bVectorized
+        );
+    });
+
+    // record the positions before the stroke of the vertices it moves for the first time (or the whole triangles,
+    // if the stroke remeshes)
+    if (TopologyChangeTracker.IsValid()) {
+        StampTriangles.Reset();
+        CollectVertexTriangles(*Mesh, StampVertices, TriangleMarkers, StampTriangles);
+        TopologyChangeTracker->SaveTriangles(StampTriangles, true);
+    } else {
+        StrokeVertexMarkers.SetNum(Mesh->MaxVertexID(), false);
+        TouchedVertexMarkers.SetNum(Mesh->MaxVertexID(), false);
+        for (int32 VertexID : StampVertices) {
+            if (StrokeVertexMarkers[VertexID] == false) {
+                StrokeVertexMarkers[VertexID] = true;
+                ActiveStrokeChange->Vertices.Add(VertexID);
+                ActiveStrokeChange->Positions.Add(Mesh->GetVertex(VertexID));
+            }
+            if (TouchedVertexMarkers[VertexID] == false) {
+                TouchedVertexMarkers[VertexID] = true;
+                TouchedVertices.Add(VertexID);
+            }
+        }
+    }
+
+    ParallelForStampRanges(NumVertices, [&](int32 Start, int32 End) {
+        for (int32 k = Start; k < End; ++k) {
+            Mesh->SetVertex(StampVertices[k], StampPositions[k], false);
+        }
+    });
+    Mesh->UpdateChangeStamps(true, false);
+
+    UpdateStampVertices();
+    if (TopologyChangeTracker.IsValid()) {
+        QueueRemesh(StampVertices);
+    }
+    return true;
+}
+
+
+void URuntimeDynamicMeshSculptTool::UpdateStampVertices() {
+    FDynamicMesh3* Mesh = SculptComponent->GetMesh();
+
+    StampTriangles.Reset();
+    RuntimeSculptLocals::CollectVertexTriangles(*Mesh, StampVertices, TriangleMarkers, StampTriangles);
+
+    SculptComponent->GetOctree()->ReinsertTriangles(StampTriangles);
+    UpdateNormals(*Mesh, StampTriangles, StampNormalElements);
+
+    // The SculptComponent splits its render buffers by octree cells, and only rebuilds the cells that
+    // ReinsertTriangles() marked as modified, so this already scales with the brush size rather than the mesh size
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_SculptStampRender);
+    SculptComponent->NotifyMeshUpdated();
+}
+
+
+void URuntimeDynamicMeshSculptTool::UpdateNormals(
+    FDynamicMesh3& Mesh, TArrayView<const int32> Triangles, TArray<int32>& Elements
+) {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_SculptStampNormals);
+
+    FDynamicMeshNormalOverlay* Normals = Mesh.HasAttributes() ? Mesh.Attributes()->PrimaryNormals() : nullptr;
+
+    // gather the overlay elements (or vertices, for per-vertex normals) of the Triangles
+    TBitArray<>& Markers = Normals ? ElementMarkers : VertexMarkers;
+    Markers.SetNum(Normals ? Normals->MaxElementID() : Mesh.MaxVertexID(), false);
+    Elements.Reset();
+    for (int32 TriangleID : Triangles) {
+        if (Normals && Normals->IsSetTriangle(TriangleID) == false) {
+            continue;
+        }
+        const FIndex3i Triangle = Normals ? Normals->GetTriangle(TriangleID) : Mesh.GetTriangle(TriangleID);
+        for (int32 j = 0; j < 3; ++j) {
+            if (Markers[Triangle[j]] == false) {
+                Markers[Triangle[j]] = true;
+                Elements.Add(Triangle[j]);
+            }
+        }
+    }
+    for (int32 ElementID : Elements) {
+        Markers[ElementID] = false;
+    }
+
+    if (Normals) {
+        ParallelForStampRanges(Elements.Num(), [&](int32 Start, int32 End) {
+            for (int32 k = Start; k < End; ++k) {
+                const int32 ElementID = Elements[k];
+                const FVector3d Normal = FMeshNormals::ComputeOverlayNormal(Mesh, Normals, ElementID);
+                Normals->SetElement(ElementID, FVector3f(Normal));
+            }
+        });
+    } else if (Mesh.HasVertexNormals()) {
+        ParallelForStampRanges(Elements.Num(), [&](int32 Start, int32 End) {
+            for (int32 k = Start; k < End; ++k) {
+                const int32 VertexID = Elements[k];
+                Mesh.SetVertexNormal(VertexID, FVector3f(FMeshNormals::ComputeVertexNormal(Mesh, VertexID)));
+            }
+        });
+    }
+}
+
+
+void FRuntimeSculptStrokeChange::SwapPositions(FDynamicMesh3& Mesh) {
+    for (int32 k = 0; k < Vertices.Num(); ++k) {
+        const FVector3d Position = Mesh.GetVertex(Vertices[k]);
+        Mesh.SetVertex(Vertices[k], Positions[k], false);
+        Positions[k] = Position;
+    }
+    Mesh.UpdateChangeStamps(true, false);
+}
+
+void FRuntimeSculptStrokeChange::Apply(UObject* Object) {
+    URuntimeDynamicMeshSculptTool* Tool = Cast<URuntimeDynamicMeshSculptTool>(Object);
+    if (Tool && Tool->SculptComponent) {
+        Tool->ApplyStrokeChange(*this, false);
+    }
+}
+
+void FRuntimeSculptStrokeChange::Revert(UObject* Object) {
+    URuntimeDynamicMeshSculptTool* Tool = Cast<URuntimeDynamicMeshSculptTool>(Object);
+    if (Tool && Tool->SculptComponent) {
+        Tool->ApplyStrokeChange(*this, true);
+    }
+}
+
+bool FRuntimeSculptStrokeChange::HasExpired(UObject* Object) const {
+    // the sculpt mesh only exists while the tool is active
+    const URuntimeDynamicMeshSculptTool* Tool = Cast<URuntimeDynamicMeshSculptTool>(Object);
+    return Tool == nullptr || Tool->SculptComponent == nullptr;
+}
+
+
+#undef LOCTEXT_NAMESPACE
@@ -23,13 +23,16 @@ void URuntimeMeshBooleanTool::Setup() {
     // to keep the Actor around for undo/redo
     this->HandleSourcesProperties->HandleInputs = EHandleSourcesMethod::KeepSources;
 
+    URuntimeToolComputeScheduler* Scheduler = UToolsSubsystem::Get()->GetComputeScheduler();
+    ComputeID = Scheduler->RegisterCompute(this, Preview);
+
     // mirror properties we want to expose at runtime
     RuntimeProperties = NewObject<URuntimeMeshBooleanToolProperties>(this);
 
     RuntimeProperties->OperationType = static_cast<int>(CSGProperties->Operation);
     RuntimeProperties->WatchProperty(RuntimeProperties->OperationType, [this](int NewType) {
         CSGProperties->Operation = static_cast<ECSGOperation>(NewType);
-        Preview->InvalidateResult();
+        UToolsSubsystem::Get()->GetComputeScheduler()->RequestRecompute(ComputeID);
     });
 
     AddToolPropertySource(RuntimeProperties);
@@ -37,6 +40,9 @@ void URuntimeMeshBooleanTool::Setup() {
 
 
 void URuntimeMeshBooleanTool::Shutdown(EToolShutdownType ShutdownType) {
+    UToolsSubsystem::Get()->GetComputeScheduler()->UnregisterCompute(ComputeID);
+    ComputeID = INDEX_NONE;
+
     if (ShutdownType == EToolShutdownType::Accept) {
         GetToolManager()->BeginUndoTransaction(GetActionName());
 
@@ -55,4 +61,13 @@ void URuntimeMeshBooleanTool::Shutdown(EToolShutdownType ShutdownType) {
 }
 
 
+void URuntimeMeshBooleanTool::OnTick(float DeltaTime) {
+    // applying a new result to the Preview can be expensive, so the Preview tick is subject to the scheduler result
+    // budget. UCSGMeshesTool::OnTick() only ticks the Preview.
+    UToolsSubsystem::Get()->GetComputeScheduler()->TickCompute(ComputeID, [this, DeltaTime]() {
+        Preview->Tick(DeltaTime);
+    });
+}
+
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
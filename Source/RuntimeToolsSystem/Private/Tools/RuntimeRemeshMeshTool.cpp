@@ -14,6 +14,9 @@ void URuntimeRemeshMeshTool::Setup() {
     // disable wireframe because it crashes at runtime
     // this->BasicProperties->bShowWireframe = false;
 
+    URuntimeToolComputeScheduler* Scheduler = UToolsSubsystem::Get()->GetComputeScheduler();
+    ComputeID = Scheduler->RegisterCompute(this, Preview);
+
     // mirror properties we want to expose at runtime
     RuntimeProperties = NewObject<URuntimeRemeshMeshToolProperties>(this);
 
@@ -21,17 +24,34 @@ void URuntimeRemeshMeshTool::Setup() {
     RuntimeProperties->WatchProperty(RuntimeProperties->bDiscardAttributes, [this](bool bNewValue) {
         BasicProperties->bDiscardAttributes = bNewValue;
         BasicProperties->bPreserveSharpEdges = !bNewValue;
-        Preview->InvalidateResult();
+        UToolsSubsystem::Get()->GetComputeScheduler()->RequestRecompute(ComputeID);
     });
 
     RuntimeProperties->TargetTriangleCount = BasicProperties->TargetTriangleCount;
     RuntimeProperties->WatchProperty(RuntimeProperties->TargetTriangleCount, [this](int NewValue) {
         BasicProperties->TargetTriangleCount = NewValue;
-        Preview->InvalidateResult();
+        UToolsSubsystem::Get()->GetComputeScheduler()->RequestRecompute(ComputeID);
     });
 
     AddToolPropertySource(RuntimeProperties);
 }
 
 
+void URuntimeRemeshMeshTool::Shutdown(EToolShutdownType ShutdownType) {
+    UToolsSubsystem::Get()->GetComputeScheduler()->UnregisterCompute(ComputeID);
+    ComputeID = INDEX_NONE;
+
+    URemeshMeshTool::Shutdown(ShutdownType);
+}
+
+
+void URuntimeRemeshMeshTool::OnTick(float DeltaTime) {
+    // applying a new result to the Preview can be expensive, so the Preview tick is subject to the scheduler result
+    // budget. URemeshMeshTool::OnTick() only ticks the Preview.
+    UToolsSubsystem::Get()->GetComputeScheduler()->TickCompute(ComputeID, [this, DeltaTime]() {
+        Preview->Tick(DeltaTime);
+    });
+}
+
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
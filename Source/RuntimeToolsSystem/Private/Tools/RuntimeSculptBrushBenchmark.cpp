@@ -0,0 +1,377 @@
+#include "Tools/RuntimeSculptBrushKernels.h"
+#include "Tools/RuntimeDynamicMeshSculptTool.h"
+#include "ToolsSubsystem.h"
+#include "MeshSceneSubsystem.h"
+#include "Interaction/SceneObject.h"
+#include "Components/OctreeDynamicMeshComponent.h"
+#include "Generators/SphereGenerator.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+using namespace UE::Geometry;
+using namespace RuntimeSculptBrushKernels;
+
+
+/**
+ * RuntimeTools.BenchmarkSculptKernels [NumVertices] [NumIterations] [FalloffAmount] [Seed]
+ *
+ * Evaluates a stamp of every ERuntimeDynamicMeshSculptBrushType on NumVertices random positions within the brush
+ * radius, NumIterations times each: with the kernel formulas evaluated one vertex at a time (reference), and with
+ * RuntimeSculptBrushKernels::EvaluateStamp() scalar and vectorized, each with the computed falloff (the default) and
+ * with the falloff table (RuntimeTools.SculptFalloffTable). The average time per stamp, the speedup over the reference
+ * and the largest deviation from it are written to the log. A mode fails if the deviation exceeds its limit: rounding
+ * only for the computed falloff, and 1e-4 of the largest displacement for the table.
+ *
+ * RuntimeTools.CompareSculptBrushes [Resolution] [FalloffAmount] [Speed]
+ *
+ * Creates a sphere SceneObject with Resolution x Resolution vertices, and applies a stroke of every
+ * ERuntimeDynamicMeshSculptBrushType to it with a URuntimeDynamicMeshSculptTool, twice: once left to the
+ * UDynamicMeshSculptTool (bApplyRuntimeStamps = false), and once with the runtime stamps, in the kernel mode selected
+ * by the RuntimeTools.Sculpt* CVars. The tool is cancelled after every stroke, so all of them start from the same mesh.
+ * The largest distance between the two results is written to the log, as a warning if it exceeds 1e-9 of the sphere
+ * radius (which the falloff table does). Needs an initialized UToolsSubsystem without an active tool. The SceneObject
+ * is deleted again, but its creation and deletion stay in the undo history.
+ */
+namespace RuntimeToolsSculptKernelBenchmark {
+
+// CalculateFalloff() and the displacement for every vertex
+static void EvaluateReference(
+    const FStampKernel& Kernel, TArrayView<const FVector3d> Positions, TArrayView<const FVector3d> VertexVectors,
+    TArrayView<FVector3d> Result
+) {
+    for (int32 k = 0; k < Positions.Num(); ++k) {
+        const FVector3d Pos = Positions[k];
+        const double Falloff = CalculateFalloff(Distance(Pos, Kernel.BrushPos), Kernel.Radius, Kernel.FalloffAmount);
+        switch (Kernel.DirectionType) {
+            case FStampKernel::EDirection::Constant:
+                Result[k] = Pos + (Falloff * Kernel.Speed) * Kernel.Direction;
+                break;
+            case FStampKernel::EDirection::PerVertex:
+                Result[k] = Pos + (Falloff * Kernel.Speed) * VertexVectors[k];
+                break;
+            case FStampKernel::EDirection::ToTarget:
+                Result[k] = Lerp(Pos, VertexVectors[k], Falloff * Kernel.Speed);
+                break;
+            case FStampKernel::EDirection::ToPlane: {
+                const FVector3d PlanePos = Pos - (Pos - Kernel.PlaneOrigin).Dot(Kernel.Direction) * Kernel.Direction;
+                Result[k] = Lerp(Pos, PlanePos, Falloff * Kernel.Speed);
+                break;
+            }
+        }
+    }
+}
+
+
+// kernel of URuntimeDynamicMeshSculptTool::ApplyStamp(), with fixed brush parameters
+static FStampKernel MakeKernel(
+    ERuntimeDynamicMeshSculptBrushType BrushType, const FVector3d& BrushPos, double Radius, double FalloffAmount
+) {
+    FRuntimeSculptStamp Stamp;
+    Stamp.BrushType = BrushType;
+    Stamp.BrushPos = BrushPos;
+    Stamp.Radius = Radius;
+    Stamp.FalloffAmount = FalloffAmount;
+    Stamp.PrimarySpeed = 0.5;
+    Stamp.SmoothSpeed = 0.5;
+    Stamp.MoveDelta = FVector3d(0.3, -0.2, 0.1) * Radius;
+    Stamp.StrokePlane = FFrame3d(BrushPos, Normalized(FVector3d(1, 1, 2)));
+    return Stamp.MakeKernel();
+}
+
+
+// @return the average milliseconds per call of StampFunc
+static double TimeStamps(int32 NumIterations, TFunctionRef<void()> StampFunc) {
+    const double StartTime = FPlatformTime::Seconds();
+    for (int32 k = 0; k < NumIterations; ++k) {
+        StampFunc();
+    }
+    return (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumIterations;
+}
+
+
+static double MaxDeviation(const TArray<FVector3d>& Result, const TArray<FVector3d>& Reference) {
+    double MaxDistance = 0;
+    for (int32 k = 0; k < Result.Num(); ++k) {
+        MaxDistance = FMathd::Max(MaxDistance, Distance(Result[k], Reference[k]));
+    }
+    return MaxDistance;
+}
+
+
+static void RunBenchmark(const TArray<FString>& Args) {
+    const int32 NumVertices = FMath::Max(1, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100000);
+    const int32 NumIterations = FMath::Max(1, Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 50);
+    const double FalloffAmount = FMathd::Clamp(Args.Num() > 2 ? FCString::Atod(*Args[2]) : 0.5, 0.0, 1.0);
+    const int32 Seed = Args.Num() > 3 ? FCString::Atoi(*Args[3]) : 31337;
+
+    // positions within the brush radius (ie the stamp ROI), random per-vertex directions, and targets a unit away
+    const double Radius = 25.0;
+    const FVector3d BrushPos(100.0, -50.0, 20.0);
+    FRandomStream Random(Seed);
+    TArray<FVector3d> Positions, Directions, Targets;
+    Positions.Reserve(NumVertices);
+    Directions.Reserve(NumVertices);
+    Targets.Reserve(NumVertices);
+    for (int32 k = 0; k < NumVertices; ++k) {
+        Positions.Add(BrushPos + FVector3d(Random.VRand()) * (Radius * Random.FRand()));
+        Directions.Add(FVector3d(Random.VRand()));
+        Targets.Add(Positions.Last() + FVector3d(Random.VRand()));
+    }
+
+    FFalloffTable FalloffTable;
+    const double TableMs = TimeStamps(1, [&]() { FalloffTable.Update(FalloffAmount); });
+    UE_LOG(
+        LogTemp, Display,
+        TEXT("[SculptKernelBenchmark] vertices=%d iterations=%d falloff=%.2f table=%d intervals (%.4fms)"),
+        NumVertices, NumIterations, FalloffAmount, FFalloffTable::NumIntervals, TableMs
+    );
+
+    struct FMode {
+        const TCHAR* Name;
+        const FFalloffTable* Table;
+        bool bVectorized;
+    };
+    const FMode Modes[] = {
+        {TEXT("exact scalar"), nullptr, false},
+        {TEXT("exact vectorized"), nullptr, true},
+        {TEXT("table scalar"), &FalloffTable, false},
+        {TEXT("table vectorized"), &FalloffTable, true},
+    };
+
+    TArray<FVector3d> ReferenceResult, Result;
+    ReferenceResult.SetNumUninitialized(NumVertices);
+    Result.SetNumUninitialized(NumVertices);
+    int32 NumChecks = 0, NumFailed = 0;
+
+    const UEnum* BrushTypeEnum = StaticEnum<ERuntimeDynamicMeshSculptBrushType>();
+    for (int32 BrushIndex = 0; BrushIndex < BrushTypeEnum->NumEnums() - 1; ++BrushIndex) {
+        const ERuntimeDynamicMeshSculptBrushType BrushType =
+            static_cast<ERuntimeDynamicMeshSculptBrushType>(BrushTypeEnum->GetValueByIndex(BrushIndex));
+        const FStampKernel Kernel = MakeKernel(BrushType, BrushPos, Radius, FalloffAmount);
+        const FString BrushName = BrushTypeEnum->GetNameStringByIndex(BrushIndex);
+        const TArray<FVector3d>& VertexVectors =
+            (Kernel.DirectionType == FStampKernel::EDirection::ToTarget) ? Targets : Directions;
+
+        const double ReferenceMs = TimeStamps(NumIterations, [&]() {
+            EvaluateReference(Kernel, Positions, VertexVectors, ReferenceResult);
+        });
+        double MaxDisplacement = 0;
+        for (int32 k = 0; k < NumVertices; ++k) {
+            MaxDisplacement = FMathd::Max(MaxDisplacement, Distance(ReferenceResult[k], Positions[k]));
+        }
+        UE_LOG(
+            LogTemp, Display, TEXT("[SculptKernelBenchmark] %-8s reference        %8.4fms"), *BrushName, ReferenceMs
+        );
+
+        for (const FMode& Mode : Modes) {
+            const double Ms = TimeStamps(NumIterations, [&]() {
+                EvaluateStamp(Kernel, Mode.Table, Positions, VertexVectors, Result, Mode.bVectorized);
+            });
+            const double Deviation = MaxDeviation(Result, ReferenceResult);
+
+            // the computed falloff does the same operations as the reference, so only rounding may differ (if the
+            // compiler contracted some of them differently)
+            const double Limit = Mode.Table ? 1e-4 * MaxDisplacement : 1e-12 * Radius;
+            const bool bPass = (Deviation <= Limit);
+            NumChecks++;
+            NumFailed += bPass ? 0 : 1;
+            if (bPass) {
+                UE_LOG(
+                    LogTemp, Display,
+                    TEXT("[SculptKernelBenchmark] %-8s %-16s %8.4fms (x%5.2f) maxdev=%.2e limit=%.2e PASS"),
+                    *BrushName, Mode.Name, Ms, ReferenceMs / Ms, Deviation, Limit
+                );
+            } else {
+                UE_LOG(
+                    LogTemp, Warning,
+                    TEXT("[SculptKernelBenchmark] %-8s %-16s %8.4fms (x%5.2f) maxdev=%.2e limit=%.2e FAIL"),
+                    *BrushName, Mode.Name, Ms, ReferenceMs / Ms, Deviation, Limit
+                );
+            }
+        }
+    }
+
+    if (NumFailed > 0) {
+        UE_LOG(LogTemp, Warning, TEXT("[SculptKernelBenchmark] %d of %d checks FAILED"), NumFailed, NumChecks);
+    } else {
+        UE_LOG(LogTemp, Display, TEXT("[SculptKernelBenchmark] all %d checks passed"), NumChecks);
+    }
+}
+
+
+// identifier the comparison registers its sculpt tool under
+static const TCHAR* CompareToolIdentifier = TEXT("RuntimeTools.CompareSculptBrushes");
+
+// Start a sculpt tool on the selected SceneObject (whose Actor is Actor), apply a stroke of BrushType along Rays (the
+// first one starts it) and cancel the tool again. The positions of the sculpt mesh vertices before and after the
+// stroke are returned in Before and After. @return false if the tool could not be started
+static bool RunStroke(
+    UToolsSubsystem* ToolsSubsystem, AActor* Actor, ERuntimeDynamicMeshSculptBrushType BrushType, bool bRuntimeStamps,
+    double FalloffAmount, double Speed, TArrayView<const FRay> Rays, TArray<FVector3d>& Before, TArray<FVector3d>& After
+) {
+    URuntimeDynamicMeshSculptTool* Tool =
+        Cast<URuntimeDynamicMeshSculptTool>(ToolsSubsystem->BeginToolByName(CompareToolIdentifier));
+    UOctreeDynamicMeshComponent* SculptComponent =
+        Tool ? Actor->FindComponentByClass<UOctreeDynamicMeshComponent>() : nullptr;
+    if (SculptComponent == nullptr) {
+        if (Tool) {
+            ToolsSubsystem->CancelOrCompleteActiveTool();
+        }
+        return false;
+    }
+
+    // the property watchers forward the RuntimeProperties to the UDynamicMeshSculptTool on the next Tick()
+    Tool->bApplyRuntimeStamps = bRuntimeStamps;
+    Tool->RuntimeProperties->SelectedBrushType = static_cast<int>(BrushType);
+    Tool->RuntimeProperties->BrushStrength = static_cast<float>(Speed);
+    Tool->RuntimeProperties->BrushFalloff = static_cast<float>(FalloffAmount);
+    Tool->Tick(0.0f);
+
+    const FDynamicMesh3* Mesh = SculptComponent->GetMesh();
+    Before.Reset();
+    for (int32 VertexID : Mesh->VertexIndicesItr()) {
+        Before.Add(Mesh->GetVertex(VertexID));
+    }
+
+    // both tools apply the pending stamp in Tick()
+    Tool->OnBeginDrag(Rays[0]);
+    Tool->Tick(0.0f);
+    for (int32 k = 1; k < Rays.Num(); ++k) {
+        Tool->OnUpdateDrag(Rays[k]);
+        Tool->Tick(0.0f);
+    }
+    Tool->OnEndDrag(Rays.Last());
+
+    After.Reset();
+    for (int32 VertexID : Mesh->VertexIndicesItr()) {
+        After.Add(Mesh->GetVertex(VertexID));
+    }
+
+    ToolsSubsystem->CancelOrCompleteActiveTool();
+    return true;
+}
+
+
+static void RunComparison(const TArray<FString>& Args) {
+    UToolsSubsystem* ToolsSubsystem = UToolsSubsystem::TryGet();
+    UMeshSceneSubsystem* SceneSubsystem = UMeshSceneSubsystem::Get();
+    if (ToolsSubsystem == nullptr || ToolsSubsystem->ToolsContext == nullptr || SceneSubsystem == nullptr ||
+        ToolsSubsystem->HaveActiveTool()) {
+        UE_LOG(
+            LogTemp, Warning,
+            TEXT("[SculptBrushComparison] requires an initialized UToolsSubsystem and UMeshSceneSubsystem, and no "
+                 "active tool")
+        );
+        return;
+    }
+
+    const int32 Resolution = FMath::Max(4, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 128);
+    const double FalloffAmount = FMathd::Clamp(Args.Num() > 1 ? FCString::Atod(*Args[1]) : 0.5, 0.0, 1.0);
+    const double Speed = FMathd::Clamp(Args.Num() > 2 ? FCString::Atod(*Args[2]) : 0.5, 0.0, 1.0);
+
+    FSphereGenerator SphereGen;
+    SphereGen.Radius = 100.0;
+    SphereGen.NumPhi = Resolution;
+    SphereGen.NumTheta = Resolution;
+    SphereGen.Generate();
+    const FDynamicMesh3 Mesh(&SphereGen);
+
+    const TArray<USceneObject*> InitialSelection = SceneSubsystem->GetSelection();
+    USceneObject* SceneObject = SceneSubsystem->CreateNewSceneObject();
+    SceneObject->Initialize(ToolsSubsystem->TargetWorld, &Mesh);
+    SceneSubsystem->SetSelected(SceneObject);
+
+    UInteractiveToolManager* ToolManager = ToolsSubsystem->ToolsContext->ToolManager;
+    ToolManager->RegisterToolType(CompareToolIdentifier, NewObject<URuntimeDynamicMeshSculptToolBuilder>(ToolManager));
+
+    // rays along the view direction at the side of the sphere that faces the camera, so that the view plane of the
+    // runtime tool and the drag plane of the UDynamicMeshSculptTool (which faces the ray) are the same. The Move
+    // stroke drags sideways from there.
+    FViewCameraState CameraState;
+    ToolManager->GetContextQueriesAPI()->GetCurrentViewState(CameraState);
+    const FVector Forward = CameraState.Forward();
+    const FVector Target = SceneObject->GetActor()->GetActorLocation() - Forward * SphereGen.Radius;
+    const FRay StampRays[] = {FRay(Target - Forward * (0.1 * SphereGen.Radius), Forward, true)};
+    const FRay MoveRays[] = {
+        StampRays[0], FRay(StampRays[0].Origin + CameraState.Right() * (0.05 * SphereGen.Radius), Forward, true)
+    };
+
+    const double Tolerance = 1e-9 * SphereGen.Radius;
+    UE_LOG(
+        LogTemp, Display,
+        TEXT("[SculptBrushComparison] vertices=%d falloff=%.2f speed=%.2f falloff table=%d vectorized=%d "
+             "tolerance=%.2e"),
+        Mesh.VertexCount(), FalloffAmount, Speed,
+        IConsoleManager::Get().FindConsoleVariable(TEXT("RuntimeTools.SculptFalloffTable"))->GetBool(),
+        IConsoleManager::Get().FindConsoleVariable(TEXT("RuntimeTools.SculptVectorizedKernels"))->GetBool(), Tolerance
+    );
+
+    TArray<FVector3d> BaseBefore, BaseResult, RuntimeBefore, RuntimeResult;
+    const UEnum* BrushTypeEnum = StaticEnum<ERuntimeDynamicMeshSculptBrushType>();
+    for (int32 BrushIndex = 0; BrushIndex < BrushTypeEnum->NumEnums() - 1; ++BrushIndex) {
+        const ERuntimeDynamicMeshSculptBrushType BrushType =
+            static_cast<ERuntimeDynamicMeshSculptBrushType>(BrushTypeEnum->GetValueByIndex(BrushIndex));
+        const TArrayView<const FRay> Rays = (BrushType == ERuntimeDynamicMeshSculptBrushType::Move)
+                                                ? MakeArrayView(MoveRays)
+                                                : MakeArrayView(StampRays);
+        const FString Name = BrushTypeEnum->GetNameStringByIndex(BrushIndex);
+
+        if (RunStroke(
+                ToolsSubsystem, SceneObject->GetActor(), BrushType, false, FalloffAmount, Speed, Rays, BaseBefore,
+                BaseResult
+            ) == false ||
+            RunStroke(
+                ToolsSubsystem, SceneObject->GetActor(), BrushType, true, FalloffAmount, Speed, Rays, RuntimeBefore,
+                RuntimeResult
+            ) == false ||
+            BaseResult.Num() != RuntimeResult.Num()) {
+            UE_LOG(LogTemp, Warning, TEXT("[SculptBrushComparison] %-8s could not be compared"), *Name);
+            continue;
+        }
+
+        double MaxDisplacement = 0;
+        int32 NumMoved = 0;
+        for (int32 k = 0; k < BaseResult.Num(); ++k) {
+            const double Displacement = Distance(BaseResult[k], BaseBefore[k]);
+            MaxDisplacement = FMathd::Max(MaxDisplacement, Displacement);
+            NumMoved += (Displacement > 0) ? 1 : 0;
+        }
+        const double Deviation = MaxDeviation(RuntimeResult, BaseResult);
+
+        if (Deviation > Tolerance || MaxDeviation(RuntimeBefore, BaseBefore) > 0) {
+            UE_LOG(
+                LogTemp, Warning,
+                TEXT("[SculptBrushComparison] %-8s moved=%d maxdisp=%.2e maxdev=%.2e: MISMATCH"), *Name, NumMoved,
+                MaxDisplacement, Deviation
+            );
+        } else {
+            UE_LOG(
+                LogTemp, Display, TEXT("[SculptBrushComparison] %-8s moved=%d maxdisp=%.2e maxdev=%.2e"), *Name,
+                NumMoved, MaxDisplacement, Deviation
+            );
+        }
+    }
+
+    ToolManager->UnregisterToolType(CompareToolIdentifier);
+    SceneSubsystem->DeleteSceneObject(SceneObject);
+    SceneSubsystem->SetSelection(InitialSelection);
+}
+
+
+static FAutoConsoleCommandWithArgs BenchmarkSculptKernelsCommand(
+    TEXT("RuntimeTools.BenchmarkSculptKernels"),
+    TEXT("Times the sculpt brush kernels, with computed and with tabulated falloff, against per-vertex falloff "
+         "evaluation, and checks their deviation. Args: [NumVertices=100000] [NumIterations=50] [FalloffAmount=0.5] "
+         "[Seed]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&RunBenchmark)
+);
+
+static FAutoConsoleCommandWithArgs CompareSculptBrushesCommand(
+    TEXT("RuntimeTools.CompareSculptBrushes"),
+    TEXT("Compares strokes of the runtime sculpt brush stamps with strokes of the UDynamicMeshSculptTool on a sphere "
+         "SceneObject. Args: [Resolution=128] [FalloffAmount=0.5] [Speed=0.5]"),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&RunComparison)
+);
+
+}  // namespace RuntimeToolsSculptKernelBenchmark
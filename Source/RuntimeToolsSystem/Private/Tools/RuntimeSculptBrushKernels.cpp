@@ -0,0 +1,259 @@
+#include "Tools/RuntimeSculptBrushKernels.h"
+#include "Math/VectorRegister.h"
+
+using namespace UE::Geometry;
+
+
+double RuntimeSculptBrushKernels::CalculateFalloff(double Distance, double Radius, double FalloffAmount) {
+    const double f = FMathd::Clamp(1.0 - FalloffAmount, 0.0, 1.0);
+    double d = Distance / Radius;
+    double w = 1;
+    if (d > f) {
+        d = FMathd::Clamp((d - f) / (1.0 - f), 0.0, 1.0);
+        w = (1.0 - d * d);
+        w = w * w * w;
+    }
+    return w;
+}
+
+
+void RuntimeSculptBrushKernels::FFalloffTable::Update(double FalloffAmount) {
+    if (FalloffAmount == TableFalloffAmount && Values.Num() > 0) {
+        return;
+    }
+    TableFalloffAmount = FalloffAmount;
+
+    Values.SetNumUninitialized(NumIntervals + 1);
+    for (int32 k = 0; k <= NumIntervals; ++k) {
+        Values[k] = CalculateFalloff(FMathd::Sqrt(static_cast<double>(k) / NumIntervals), 1.0, FalloffAmount);
+    }
+}
+
+
+namespace RuntimeSculptBrushKernelsLocals {
+
+using namespace RuntimeSculptBrushKernels;
+
+// vertices per block of the vectorized kernels, a multiple of the vector width
+static constexpr int32 BlockSize = 64;
+static constexpr int32 VectorWidth = 4;
+
+static VectorRegister4Double Splat(double Value) {
+    return MakeVectorRegisterDouble(Value, Value, Value, Value);
+}
+
+// (1 - Alpha) * A + Alpha * B, like UE::Geometry::Lerp()
+static VectorRegister4Double VectorLerp(
+    const VectorRegister4Double& A, const VectorRegister4Double& B, const VectorRegister4Double& Alpha,
+    const VectorRegister4Double& OneMinusAlpha
+) {
+    return VectorAdd(VectorMultiply(OneMinusAlpha, A), VectorMultiply(Alpha, B));
+}
+
+// the scalar kernel for one vertex
+static FVector3d EvaluateVertex(
+    const FStampKernel& Kernel, const FVector3d& Pos, const FVector3d& VertexVector, double Falloff
+) {
+    switch (Kernel.DirectionType) {
+        case FStampKernel::EDirection::Constant:
+            return Pos + (Falloff * Kernel.Speed) * Kernel.Direction;
+        case FStampKernel::EDirection::PerVertex:
+            return Pos + (Falloff * Kernel.Speed) * VertexVector;
+        case FStampKernel::EDirection::ToTarget:
+            return Lerp(Pos, VertexVector, Falloff * Kernel.Speed);
+        case FStampKernel::EDirection::ToPlane: {
+            const FVector3d PlanePos = Pos - (Pos - Kernel.PlaneOrigin).Dot(Kernel.Direction) * Kernel.Direction;
+            return Lerp(Pos, PlanePos, Falloff * Kernel.Speed);
+        }
+    }
+    return Pos;
+}
+
+// With bFalloffTable, the falloff is looked up in the FalloffTable. Otherwise it is computed like CalculateFalloff().
+template<FStampKernel::EDirection DirectionType, bool bFalloffTable>
+static void EvaluateStampVectorized(
+    const FStampKernel& Kernel, const FFalloffTable* FalloffTable, TArrayView<const FVector3d> Positions,
+    TArrayView<const FVector3d> VertexVectors, TArrayView<FVector3d> Result
+) {
+    alignas(32) double X[BlockSize], Y[BlockSize], Z[BlockSize], W[BlockSize];
+    alignas(32) double VX[BlockSize], VY[BlockSize], VZ[BlockSize];
+
+    const VectorRegister4Double BrushX = Splat(Kernel.BrushPos.X);
+    const VectorRegister4Double BrushY = Splat(Kernel.BrushPos.Y);
+    const VectorRegister4Double BrushZ = Splat(Kernel.BrushPos.Z);
+    const VectorRegister4Double Radius = Splat(Kernel.Radius);
+    const VectorRegister4Double InvRadiusSqr = Splat(1.0 / (Kernel.Radius * Kernel.Radius));
+    const VectorRegister4Double Speed = Splat(Kernel.Speed);
+    const VectorRegister4Double DirX = Splat(Kernel.Direction.X);
+    const VectorRegister4Double DirY = Splat(Kernel.Direction.Y);
+    const VectorRegister4Double DirZ = Splat(Kernel.Direction.Z);
+    const VectorRegister4Double PlaneX = Splat(Kernel.PlaneOrigin.X);
+    const VectorRegister4Double PlaneY = Splat(Kernel.PlaneOrigin.Y);
+    const VectorRegister4Double PlaneZ = Splat(Kernel.PlaneOrigin.Z);
+
+    // CalculateFalloff() constants
+    const double FalloffStart = FMathd::Clamp(1.0 - Kernel.FalloffAmount, 0.0, 1.0);
+    const VectorRegister4Double Zero = Splat(0.0);
+    const VectorRegister4Double One = Splat(1.0);
+    const VectorRegister4Double F = Splat(FalloffStart);
+    const VectorRegister4Double OneMinusF = Splat(1.0 - FalloffStart);
+
+    for (int32 BlockStart = 0; BlockStart < Positions.Num(); BlockStart += BlockSize) {
+        const int32 Num = FMath::Min(BlockSize, Positions.Num() - BlockStart);
+        const int32 NumPadded = FMath::DivideAndRoundUp(Num, VectorWidth) * VectorWidth;
+
+        // gather into structure-of-arrays form. The padding is evaluated as well, but not written back.
+        for (int32 k = 0; k < NumPadded; ++k) {
+            const FVector3d& Pos = Positions[BlockStart + FMath::Min(k, Num - 1)];
+            X[k] = Pos.X;
+            Y[k] = Pos.Y;
+            Z[k] = Pos.Z;
+        }
+        if constexpr (
+            DirectionType == FStampKernel::EDirection::PerVertex || DirectionType == FStampKernel::EDirection::ToTarget
+        ) {
+            for (int32 k = 0; k < NumPadded; ++k) {
+                const FVector3d& Vector = VertexVectors[BlockStart + FMath::Min(k, Num - 1)];
+                VX[k] = Vector.X;
+                VY[k] = Vector.Y;
+                VZ[k] = Vector.Z;
+            }
+        }
+
+        // falloff
+        for (int32 k = 0; k < NumPadded; k += VectorWidth) {
+            const VectorRegister4Double OffsetX = VectorSubtract(VectorLoad(X + k), BrushX);
+            const VectorRegister4Double OffsetY = VectorSubtract(VectorLoad(Y + k), BrushY);
+            const VectorRegister4Double OffsetZ = VectorSubtract(VectorLoad(Z + k), BrushZ);
+            VectorRegister4Double DistanceSqr = VectorMultiply(OffsetX, OffsetX);
+            DistanceSqr = VectorAdd(DistanceSqr, VectorMultiply(OffsetY, OffsetY));
+            DistanceSqr = VectorAdd(DistanceSqr, VectorMultiply(OffsetZ, OffsetZ));
+            if constexpr (bFalloffTable) {
+                VectorStore(VectorMultiply(DistanceSqr, InvRadiusSqr), W + k);
+            } else {
+                const VectorRegister4Double D = VectorDivide(VectorSqrt(DistanceSqr), Radius);
+                const VectorRegister4Double T =
+                    VectorMin(VectorMax(VectorDivide(VectorSubtract(D, F), OneMinusF), Zero), One);
+                const VectorRegister4Double OneMinusTSqr = VectorSubtract(One, VectorMultiply(T, T));
+                const VectorRegister4Double Falloff =
+                    VectorMultiply(VectorMultiply(OneMinusTSqr, OneMinusTSqr), OneMinusTSqr);
+                VectorStore(VectorSelect(VectorCompareGT(D, F), Falloff, One), W + k);
+            }
+        }
+        if constexpr (bFalloffTable) {
+            for (int32 k = 0; k < NumPadded; ++k) {
+                W[k] = FalloffTable->Evaluate(W[k]);
+            }
+        }
+
+        // displacement
+        for (int32 k = 0; k < NumPadded; k += VectorWidth) {
+            const VectorRegister4Double PosX = VectorLoad(X + k);
+            const VectorRegister4Double PosY = VectorLoad(Y + k);
+            const VectorRegister4Double PosZ = VectorLoad(Z + k);
+            const VectorRegister4Double Scale = VectorMultiply(VectorLoad(W + k), Speed);
+            if constexpr (DirectionType == FStampKernel::EDirection::ToTarget) {
+                const VectorRegister4Double OneMinusScale = VectorSubtract(One, Scale);
+                VectorStore(VectorLerp(PosX, VectorLoad(VX + k), Scale, OneMinusScale), X + k);
+                VectorStore(VectorLerp(PosY, VectorLoad(VY + k), Scale, OneMinusScale), Y + k);
+                VectorStore(VectorLerp(PosZ, VectorLoad(VZ + k), Scale, OneMinusScale), Z + k);
+            } else if constexpr (DirectionType == FStampKernel::EDirection::ToPlane) {
+                VectorRegister4Double PlaneDistance = VectorMultiply(VectorSubtract(PosX, PlaneX), DirX);
+                PlaneDistance = VectorAdd(PlaneDistance, VectorMultiply(VectorSubtract(PosY, PlaneY), DirY));
+                PlaneDistance = VectorAdd(PlaneDistance, VectorMultiply(VectorSubtract(PosZ, PlaneZ), DirZ));
+                const VectorRegister4Double OneMinusScale = VectorSubtract(One, Scale);
+                const VectorRegister4Double PlanePosX = VectorSubtract(PosX, VectorMultiply(PlaneDistance, DirX));
+                const VectorRegister4Double PlanePosY = VectorSubtract(PosY, VectorMultiply(PlaneDistance, DirY));
+                const VectorRegister4Double PlanePosZ = VectorSubtract(PosZ, VectorMultiply(PlaneDistance, DirZ));
+                VectorStore(VectorLerp(PosX, PlanePosX, Scale, OneMinusScale), X + k);
+                VectorStore(VectorLerp(PosY, PlanePosY, Scale, OneMinusScale), Y + k);
+                VectorStore(VectorLerp(PosZ, PlanePosZ, Scale, OneMinusScale), Z + k);
+            } else {
+                VectorRegister4Double MoveX = DirX, MoveY = DirY, MoveZ = DirZ;
+                if constexpr (DirectionType == FStampKernel::EDirection::PerVertex) {
+                    MoveX = VectorLoad(VX + k);
+                    MoveY = VectorLoad(VY + k);
+                    MoveZ = VectorLoad(VZ + k);
+                }
+                VectorStore(VectorAdd(PosX, VectorMultiply(Scale, MoveX)), X + k);
+                VectorStore(VectorAdd(PosY, VectorMultiply(Scale, MoveY)), Y + k);
+                VectorStore(VectorAdd(PosZ, VectorMultiply(Scale, MoveZ)), Z + k);
+            }
+        }
+
+        for (int32 k = 0; k < Num; ++k) {
+            Result[BlockStart + k] = FVector3d(X[k], Y[k], Z[k]);
+        }
+    }
+}
+
+template<FStampKernel::EDirection DirectionType>
+static void EvaluateStampVectorized(
+    const FStampKernel& Kernel, const FFalloffTable* FalloffTable, TArrayView<const FVector3d> Positions,
+    TArrayView<const FVector3d> VertexVectors, TArrayView<FVector3d> Result
+) {
+    if (FalloffTable) {
+        EvaluateStampVectorized<DirectionType, true>(Kernel, FalloffTable, Positions, VertexVectors, Result);
+    } else {
+        EvaluateStampVectorized<DirectionType, false>(Kernel, FalloffTable, Positions, VertexVectors, Result);
+    }
+}
+
+static void EvaluateStampScalar(
+    const FStampKernel& Kernel, const FFalloffTable* FalloffTable, TArrayView<const FVector3d> Positions,
+    TArrayView<const FVector3d> VertexVectors, TArrayView<FVector3d> Result
+) {
+    const bool bVertexVectors = (Kernel.DirectionType == FStampKernel::EDirection::PerVertex ||
+                                 Kernel.DirectionType == FStampKernel::EDirection::ToTarget);
+    const double InvRadiusSqr = 1.0 / (Kernel.Radius * Kernel.Radius);
+    for (int32 k = 0; k < Positions.Num(); ++k) {
+        const FVector3d Pos = Positions[k];
+        const double Falloff =
+            FalloffTable ? FalloffTable->Evaluate(DistanceSquared(Pos, Kernel.BrushPos) * InvRadiusSqr)
+                         : CalculateFalloff(Distance(Pos, Kernel.BrushPos), Kernel.Radius, Kernel.FalloffAmount);
+        Result[k] = EvaluateVertex(Kernel, Pos, bVertexVectors ? VertexVectors[k] : Kernel.Direction, Falloff);
+    }
+}
+
+}  // namespace RuntimeSculptBrushKernelsLocals
+
+
+void RuntimeSculptBrushKernels::EvaluateStamp(
+    const FStampKernel& Kernel, const FFalloffTable* FalloffTable, TArrayView<const FVector3d> Positions,
+    TArrayView<const FVector3d> VertexVectors, TArrayView<FVector3d> Result, bool bVectorized
+) {
+    using namespace RuntimeSculptBrushKernelsLocals;
+    check(Result.Num() == Positions.Num());
+    check(
+        (Kernel.DirectionType != FStampKernel::EDirection::PerVertex &&
+         Kernel.DirectionType != FStampKernel::EDirection::ToTarget) ||
+        VertexVectors.Num() == Positions.Num()
+    );
+
+    if (bVectorized == false) {
+        EvaluateStampScalar(Kernel, FalloffTable, Positions, VertexVectors, Result);
+        return;
+    }
+    switch (Kernel.DirectionType) {
+        case FStampKernel::EDirection::Constant:
+            EvaluateStampVectorized<FStampKernel::EDirection::Constant>(
+                Kernel, FalloffTable, Positions, VertexVectors, Result
+            );
+            break;
+        case FStampKernel::EDirection::PerVertex:
+            EvaluateStampVectorized<FStampKernel::EDirection::PerVertex>(
+                Kernel, FalloffTable, Positions, VertexVectors, Result
+            );
+            break;
+        case FStampKernel::EDirection::ToTarget:
+            EvaluateStampVectorized<FStampKernel::EDirection::ToTarget>(
+                Kernel, FalloffTable, Positions, VertexVectors, Result
+            );
+            break;
+        case FStampKernel::EDirection::ToPlane:
+            EvaluateStampVectorized<FStampKernel::EDirection::ToPlane>(
+                Kernel, FalloffTable, Positions, VertexVectors, Result
+            );
+            break;
+    }
+}
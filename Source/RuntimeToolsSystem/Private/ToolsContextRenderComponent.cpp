@@ -1,12 +1,329 @@
 #include "ToolsContextRenderComponent.h"
 #include "PrimitiveSceneProxy.h"
 #include "SceneManagement.h"
+#include "DynamicMeshBuilder.h"
+#include "LocalVertexFactory.h"
+#include "RHICommandList.h"
+#include "Materials/MaterialInterface.h"
+#include "Materials/MaterialRenderProxy.h"
+#include "ToolSetupUtil.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include "Async/ParallelFor.h"
+#include "RenderingThread.h"
+#include "RuntimeToolsStats.h"
 
 
-// SceneProxy for UToolsContextRenderComponent. Just uses the PDI's available in GetDynamicMeshElements
-// to draw the lines/points accumulated by the Component.
+DECLARE_CYCLE_STAT(
+    TEXT("Overlay GetDynamicMeshElements"), STAT_RuntimeTools_OverlayMeshElements, STATGROUP_RuntimeTools
+);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Overlay Published Lines"), STAT_RuntimeTools_PublishedLines, STATGROUP_RuntimeTools);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Overlay Published Points"), STAT_RuntimeTools_PublishedPoints, STATGROUP_RuntimeTools);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Overlay Layers"), STAT_RuntimeTools_OverlayLayers, STATGROUP_RuntimeTools);
+DECLARE_DWORD_COUNTER_STAT(
+    TEXT("Overlay Batched Primitives"), STAT_RuntimeTools_BatchedPrimitives, STATGROUP_RuntimeTools
+);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Overlay Rebuilt Layers"), STAT_RuntimeTools_RebuiltLayers, STATGROUP_RuntimeTools);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Overlay PDI Primitives"), STAT_RuntimeTools_PDIPrimitives, STATGROUP_RuntimeTools);
+
+
+static TAutoConsoleVariable<int32> CVarBatchedOverlayRendering(
+    TEXT("RuntimeTools.BatchedOverlayRendering"), 1,
+    TEXT("If non-zero, UToolsContextRenderComponent draws its lines/points as a few vertex-buffer mesh batches "
+         "instead of one PDI call per primitive."),
+    ECVF_RenderThreadSafe
+);
+
+static TAutoConsoleVariable<int32> CVarParallelPointThreshold(
+    TEXT("RuntimeTools.ParallelPointThreshold"), 16384,
+    TEXT("Point sets with at least this many points are written into their vertex buffers in parallel chunks."),
+    ECVF_RenderThreadSafe
+);
+
+
+namespace ToolsContextRenderLocals {
+
+// batches are grouped by depth priority: index 0 is depth-tested (SDPG_World), index 1 is overlaid (SDPG_Foreground)
+static constexpr int32 NumBatchGroups = 2;
+
+static int32 GetBatchGroup(uint8 DepthPriorityGroup) {
+    return (DepthPriorityGroup == SDPG_Foreground) ? 1 : 0;
+}
+
+// world-space thick lines cannot be expressed by the line-set material, which sizes lines in pixels
+static bool CanBatchLine(const UToolsContextRenderComponent::FPDILine& Line) {
+    return Line.Thickness <= 0.0f || Line.bScreenSpace;
+}
+
+// number of points per task when writing large point sets in parallel
+static constexpr int32 PointChunkSize = 4096;
+
+// @return true if the world-space Box (of lines/points, which have a screen-space size, so it is padded a bit)
+// intersects the view frustum
+static bool IsBoxInView(const FSceneView* View, const FBox& Box) {
+    if (Box.IsValid == false) {
+        return false;
+    }
+    const FBox CullBounds = Box.ExpandBy(1.0);
+    return View->ViewFrustum.IntersectBox(CullBounds.GetCenter(), CullBounds.GetExtent());
+}
+
+// @return the subset of VisibilityMap whose views see Box
+static uint32 GetBoxVisibilityMap(const TArray<const FSceneView*>& Views, uint32 VisibilityMap, const FBox& Box) {
+    uint32 Result = 0;
+    for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++) {
+        if ((VisibilityMap & (1 << ViewIndex)) && IsBoxInView(Views[ViewIndex], Box)) {
+            Result |= (1 << ViewIndex);
+        }
+    }
+    return Result;
+}
+
+}  // namespace ToolsContextRenderLocals
+
+
+// Vertex buffer of a FToolsContextPrimitiveBatch, with a CPU-side copy that the batch writes and Update() uploads.
+// Unlike the FStaticMeshVertexBuffers (which always create BUF_Static buffers), the GPU buffer is BUF_Dynamic, as the
+// batches of the per-frame geometry are rewritten every frame.
+template <typename VertexType>
+class TToolsContextDynamicVertexBuffer final : public FVertexBuffer {
+public:
+    TArray<VertexType> Vertices;
+    FShaderResourceViewRHIRef SRV;
+
+    // SRVFormat is the format in which the vertex factory reads the buffer with manual vertex fetch
+    explicit TToolsContextDynamicVertexBuffer(EPixelFormat SRVFormat) : Format(SRVFormat) {}
+
+    virtual void InitRHI(FRHICommandListBase& RHICmdList) override {
+        FRHIResourceCreateInfo CreateInfo(TEXT("FToolsContextPrimitiveBatch"));
+        VertexBufferRHI = RHICmdList.CreateVertexBuffer(
+            Vertices.Num() * sizeof(VertexType), BUF_Dynamic | BUF_ShaderResource, CreateInfo
+        );
+        SRV = RHICmdList.CreateShaderResourceView(
+            VertexBufferRHI, FRHIViewDesc::CreateBufferSRV().SetType(FRHIViewDesc::EBufferType::Typed).SetFormat(Format)
+        );
+    }
+
+    virtual void ReleaseRHI() override {
+        SRV.SafeRelease();
+        FVertexBuffer::ReleaseRHI();
+    }
+
+    // copy the first NumVertices vertices into the GPU buffer
+    void Update(FRHICommandListBase& RHICmdList, int32 NumVertices) {
+        const uint32 NumBytes = NumVertices * sizeof(VertexType);
+        void* BufferData = RHICmdList.LockBuffer(VertexBufferRHI, 0, NumBytes, RLM_WriteOnly);
+        FMemory::Memcpy(BufferData, Vertices.GetData(), NumBytes);
+        RHICmdList.UnlockBuffer(VertexBufferRHI);
+    }
+
+protected:
+    EPixelFormat Format;
+};
+
+
+// Vertex buffers for a set of lines or points, in the vertex layout expected by the ModelingComponents
+// line-set and point-set materials (each primitive is a quad that the material expands in screen space).
+// Thickness/point size are stored per-vertex, so primitives of any thickness can share one batch.
+// All quads use the same index pattern, so the batches are drawn with the SceneProxy's shared quad index buffer.
+// Batches are owned by the SceneProxy and kept across frames: the buffers are only reallocated when a frame needs more
+// quads than they have room for, and otherwise the used part of the (dynamic) GPU buffers is rewritten in place.
+class FToolsContextPrimitiveBatch {
+public:
+    struct FTangents {
+        FPackedNormal TangentX;
+        FPackedNormal TangentZ;
+    };
+
+    TToolsContextDynamicVertexBuffer<FVector3f> Positions{PF_R32_FLOAT};
+    TToolsContextDynamicVertexBuffer<FTangents> Tangents{PF_R8G8B8A8_SNORM};
+    TToolsContextDynamicVertexBuffer<FVector2f> TexCoords{PF_G32R32F};
+    TToolsContextDynamicVertexBuffer<FColor> Colors{PF_R8G8B8A8};
+    FLocalVertexFactory VertexFactory;
+
+    int32 NumPrimitives = 0;
+
+    // number of quads the buffers are allocated for
+    int32 Capacity = 0;
+
+    // world-space bounds of the batch, used for per-view culling
+    FBox Bounds = FBox(ForceInit);
+
+    explicit FToolsContextPrimitiveBatch(ERHIFeatureLevel::Type FeatureLevel) :
+        VertexFactory(FeatureLevel, "FToolsContextPrimitiveBatch") {}
+
+    virtual ~FToolsContextPrimitiveBatch() {
+        ReleaseResources();
+    }
+
+    // start writing NumQuads quads. The buffers are only reallocated (with some room to grow) if they are too small.
+    void Allocate(int32 NumQuads) {
+        if (NumQuads > Capacity) {
+            ReleaseResources();
+            Capacity = FMath::Max(NumQuads, Capacity + Capacity / 2);
+            Positions.Vertices.SetNumUninitialized(4 * Capacity);
+            Tangents.Vertices.SetNumUninitialized(4 * Capacity);
+            TexCoords.Vertices.SetNumUninitialized(4 * Capacity);
+            Colors.Vertices.SetNumUninitialized(4 * Capacity);
+        }
+        NumPrimitives = 0;
+        Bounds = FBox(ForceInit);
+    }
+
+    void AddLine(const UToolsContextRenderComponent::FPDILine& Line) {
+        const FVector3f Direction = FVector3f(Line.End - Line.Start).GetSafeNormal();
+        const FVector2f UV(FMath::Max(Line.Thickness, 1.0f), Line.DepthBias);
+        const FColor Color = Line.Color.ToFColor(true);
+
+        Bounds += Line.Start;
+        Bounds += Line.End;
+
+        const uint32 V = 4 * NumPrimitives;
+        SetVertex(V + 0, FVector3f(Line.Start), FVector3f::ZeroVector, -Direction, UV, Color);
+        SetVertex(V + 1, FVector3f(Line.End), FVector3f::ZeroVector, -Direction, UV, Color);
+        SetVertex(V + 2, FVector3f(Line.End), FVector3f::ZeroVector, Direction, UV, Color);
+        SetVertex(V + 3, FVector3f(Line.Start), FVector3f::ZeroVector, Direction, UV, Color);
+        NumPrimitives++;
+    }
+
+    void AddPoint(const UToolsContextRenderComponent::FPDIPoint& Point) {
+        Bounds += Point.Position;
+        WritePoint(NumPrimitives++, Point);
+    }
+
+    // write the quad of a point into slot QuadIndex (which must have been allocated). Does not update Bounds or
+    // NumPrimitives, so that different slots can be written concurrently.
+    void WritePoint(int32 QuadIndex, const UToolsContextRenderComponent::FPDIPoint& Point) {
+        const FVector3f Position(Point.Position);
+        const FVector2f UV(Point.PointSize, 0.0f);
+        const FColor Color = Point.Color.ToFColor(true);
+
+        // corner offsets are passed in TangentX
+        const uint32 V = 4 * QuadIndex;
+        SetVertex(V + 0, Position, FVector3f(1, -1, 0), FVector3f::ZeroVector, UV, Color);
+        SetVertex(V + 1, Position, FVector3f(1, 1, 0), FVector3f::ZeroVector, UV, Color);
+        SetVertex(V + 2, Position, FVector3f(-1, 1, 0), FVector3f::ZeroVector, UV, Color);
+        SetVertex(V + 3, Position, FVector3f(-1, -1, 0), FVector3f::ZeroVector, UV, Color);
+    }
+
+    // upload the quads written since Allocate(), after creating the GPU buffers if they were reallocated
+    void UpdateResources(FRHICommandListBase& RHICmdList) {
+        if (bResourcesInitialized == false) {
+            InitResources(RHICmdList);
+        }
+
+        const int32 NumVertices = 4 * NumPrimitives;
+        if (NumVertices == 0) {
+            return;
+        }
+        Positions.Update(RHICmdList, NumVertices);
+        Tangents.Update(RHICmdList, NumVertices);
+        TexCoords.Update(RHICmdList, NumVertices);
+        Colors.Update(RHICmdList, NumVertices);
+    }
+
+protected:
+    bool bResourcesInitialized = false;
+
+    void InitResources(FRHICommandListBase& RHICmdList) {
+        Positions.InitResource(RHICmdList);
+        Tangents.InitResource(RHICmdList);
+        TexCoords.InitResource(RHICmdList);
+        Colors.InitResource(RHICmdList);
+
+        // the same streams that the FStaticMeshVertexBuffers bind, with full-precision UVs
+        FLocalVertexFactory::FDataType Data;
+        Data.PositionComponent = FVertexStreamComponent(&Positions, 0, sizeof(FVector3f), VET_Float3);
+        Data.PositionComponentSRV = Positions.SRV;
+        Data.TangentBasisComponents[0] = FVertexStreamComponent(
+            &Tangents, STRUCT_OFFSET(FTangents, TangentX), sizeof(FTangents), VET_PackedNormal
+        );
+        Data.TangentBasisComponents[1] = FVertexStreamComponent(
+            &Tangents, STRUCT_OFFSET(FTangents, TangentZ), sizeof(FTangents), VET_PackedNormal
+        );
+        Data.TangentsSRV = Tangents.SRV;
+        Data.TextureCoordinates.Add(FVertexStreamComponent(&TexCoords, 0, sizeof(FVector2f), VET_Float2));
+        Data.TextureCoordinatesSRV = TexCoords.SRV;
+        Data.NumTexCoords = 1;
+        Data.ColorComponent = FVertexStreamComponent(&Colors, 0, sizeof(FColor), VET_Color);
+        Data.ColorComponentsSRV = Colors.SRV;
+        Data.ColorIndexMask = ~0u;
+        VertexFactory.SetData(RHICmdList, Data);
+        VertexFactory.InitResource(RHICmdList);
+        bResourcesInitialized = true;
+    }
+
+    void ReleaseResources() {
+        if (bResourcesInitialized) {
+            Positions.ReleaseResource();
+            Tangents.ReleaseResource();
+            TexCoords.ReleaseResource();
+            Colors.ReleaseResource();
+            VertexFactory.ReleaseResource();
+            bResourcesInitialized = false;
+        }
+    }
+
+    void SetVertex(
+        uint32 Index, const FVector3f& Position, const FVector3f& TangentX, const FVector3f& TangentZ,
+        const FVector2f& UV, const FColor& Color
+    ) {
+        Positions.Vertices[Index] = Position;
+        // W is the sign of the (degenerate) tangent basis, as FStaticMeshVertexBuffer::SetVertexTangents() stores it
+        Tangents.Vertices[Index] = FTangents{FPackedNormal(TangentX), FPackedNormal(FVector4f(TangentZ, 1.0f))};
+        TexCoords.Vertices[Index] = UV;
+        Colors.Vertices[Index] = Color;
+    }
+};
+
+
+
+// SceneProxy for UToolsContextRenderComponent. The most recent published frame is kept, so that the
+// geometry is still drawn if the render thread gets ahead of the game thread. Lines/points are written into
+// one vertex-buffer batch per depth-priority group, built once and shared by all views (large point sets are
+// written in parallel, and all batches share one quad index buffer). Anything the batch materials cannot express
+// (or everything, if batching is disabled) goes through the PDI's available in GetDynamicMeshElements.
+// Retained overlay layers keep their batches across frames, and only rebuild them when their geometry changes.
+// The Component bounds are conservative, so the frame and each layer are culled per view against the bounds they
+// carry themselves, and neither built nor drawn when no view sees them.
 class FToolsContextRenderComponentSceneProxy final : public FPrimitiveSceneProxy {
 public:
+    using FBatch = FToolsContextPrimitiveBatch;
+    using FLayerGeometryPtr =
+        TSharedPtr<const UToolsContextRenderComponent::FOverlayLayerGeometry, ESPMode::ThreadSafe>;
+
+    // batches built from one set of lines/points. The batch of each depth-priority group is kept when its group
+    // becomes empty, so that it can be refilled without reallocation.
+    struct FBatchSet {
+        TUniquePtr<FBatch> OwnedLineBatches[ToolsContextRenderLocals::NumBatchGroups];
+        TUniquePtr<FBatch> OwnedPointBatches[ToolsContextRenderLocals::NumBatchGroups];
+
+        // batches of the groups that are not empty, null otherwise
+        FBatch* LineBatches[ToolsContextRenderLocals::NumBatchGroups] = {};
+        FBatch* PointBatches[ToolsContextRenderLocals::NumBatchGroups] = {};
+        int32 NumUnbatchedLines = 0;
+
+        void Build(
+            TArrayView<const UToolsContextRenderComponent::FPDILine> Lines,
+            TArrayView<const UToolsContextRenderComponent::FPDIPoint> Points, ERHIFeatureLevel::Type FeatureLevel,
+            FRHICommandListBase& RHICmdList
+        ) {
+            NumUnbatchedLines = BuildBatches(
+                Lines, Points, OwnedLineBatches, OwnedPointBatches, LineBatches, PointBatches, FeatureLevel, RHICmdList
+            );
+        }
+    };
+
+    // render-thread state of a retained overlay layer
+    struct FRetainedLayer {
+        FLayerGeometryPtr Geometry;
+        bool bVisible = true;
+
+        // batches built from Geometry, if bBatchesValid
+        bool bBatchesValid = false;
+        FBatchSet Batches;
+    };
+
     virtual SIZE_T GetTypeHash() const override {
         static size_t UniquePointer;
         return reinterpret_cast<size_t>(&UniquePointer);
@@ -14,43 +331,360 @@ public:
 
     FToolsContextRenderComponentSceneProxy(
         const UToolsContextRenderComponent* InComponent,
-        TUniqueFunction<
-            void(TArray<UToolsContextRenderComponent::FPDILine>&, TArray<UToolsContextRenderComponent::FPDIPoint>&)>&&
-            GeometryQueryFunc
+        TUniqueFunction<const UToolsContextRenderComponent::FGeometryFrame&()>&& GeometryQueryFunc
     ) :
         FPrimitiveSceneProxy(InComponent) {
         GetGeometryQueryFunc = MoveTemp(GeometryQueryFunc);
+
+        LineMaterials[0] = InComponent->LineMaterial;
+        LineMaterials[1] = InComponent->OverlaidLineMaterial;
+        PointMaterials[0] = InComponent->PointMaterial;
+        PointMaterials[1] = InComponent->OverlaidPointMaterial;
+
+        bHaveBatchMaterials = true;
+        for (int32 Group = 0; Group < ToolsContextRenderLocals::NumBatchGroups; ++Group) {
+            for (UMaterialInterface* Material : {LineMaterials[Group], PointMaterials[Group]}) {
+                if (Material) {
+                    MaterialRelevance |= Material->GetRelevance_Concurrent(GetScene().GetFeatureLevel());
+                } else {
+                    bHaveBatchMaterials = false;
+                }
+            }
+        }
+
+        // a re-created proxy has to pick up the existing layers (the proxy is not on the render thread yet)
+        for (const TPair<int32, UToolsContextRenderComponent::FOverlayLayer>& Layer : InComponent->OverlayLayers) {
+            SetOverlayLayer(Layer.Key, Layer.Value.Geometry, Layer.Value.bVisible);
+        }
+    }
+
+    virtual ~FToolsContextRenderComponentSceneProxy() {
+        SharedQuadIndices.ReleaseResource();
+    }
+
+    // add, update or (if Geometry is null) remove a retained layer. Render thread only.
+    void SetOverlayLayer(int32 LayerID, FLayerGeometryPtr Geometry, bool bVisible) {
+        if (Geometry.IsValid() == false) {
+            RetainedLayers.Remove(LayerID);
+            return;
+        }
+        FRetainedLayer& Layer = RetainedLayers.FindOrAdd(LayerID);
+        if (Layer.Geometry != Geometry) {
+            Layer.Geometry = MoveTemp(Geometry);
+            Layer.bBatchesValid = false;
+        }
+        Layer.bVisible = bVisible;
     }
 
     virtual void GetDynamicMeshElements(
         const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap,
         FMeshElementCollector& Collector
     ) const override {
-        TArray<UToolsContextRenderComponent::FPDILine> Lines;
-        TArray<UToolsContextRenderComponent::FPDIPoint> Points;
-        GetGeometryQueryFunc(Lines, Points);
+        using namespace ToolsContextRenderLocals;
+        RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_OverlayMeshElements);
+
+        const UToolsContextRenderComponent::FGeometryFrame& RenderFrame = GetGeometryQueryFunc();
+        const TArray<UToolsContextRenderComponent::FPDILine>& Lines = RenderFrame.Lines;
+        const TArray<UToolsContextRenderComponent::FPDIPoint>& Points = RenderFrame.Points;
+
+        const bool bBatched = bHaveBatchMaterials && CVarBatchedOverlayRendering.GetValueOnRenderThread() != 0;
+
+        // the frame bounds come with the frame, so they always match the geometry that is drawn
+        const uint32 FrameVisibilityMap = GetBoxVisibilityMap(Views, VisibilityMap, RenderFrame.Bounds);
+        auto GetLayerVisibilityMap = [&](const FRetainedLayer& Layer) -> uint32 {
+            return Layer.bVisible ? GetBoxVisibilityMap(Views, VisibilityMap, Layer.Geometry->Bounds) : 0;
+        };
+
+        // GetDynamicMeshElements() is called once per view family (e.g. scene captures, or split-screen/multiple
+        // viewports rendered separately), but the published frame is in world space, so its vertex buffers are only
+        // built the first time a new frame is drawn and then shared by all views until the next one arrives
+        if (bBatched) {
+            FRHICommandListBase& RHICmdList = Collector.GetRHICommandList();
+            const ERHIFeatureLevel::Type FeatureLevel = ViewFamily.GetFeatureLevel();
+            const bool bNewFrame =
+                FrameBatchesSource != &RenderFrame || FrameBatchesFrameNumber != RenderFrame.FrameNumber;
+            if (bNewFrame && FrameVisibilityMap != 0) {
+                FrameBatches.Build(Lines, Points, FeatureLevel, RHICmdList);
+                FrameBatchesSource = &RenderFrame;
+                FrameBatchesFrameNumber = RenderFrame.FrameNumber;
+            }
+
+            // retained layers only rebuild their batches if their geometry has changed (and is seen by some view)
+            for (TPair<int32, FRetainedLayer>& LayerPair : RetainedLayers) {
+                FRetainedLayer& Layer = LayerPair.Value;
+                if (Layer.bBatchesValid == false && GetLayerVisibilityMap(Layer) != 0) {
+                    Layer.Batches.Build(Layer.Geometry->Lines, Layer.Geometry->Points, FeatureLevel, RHICmdList);
+                    Layer.bBatchesValid = true;
+                    INC_DWORD_STAT(STAT_RuntimeTools_RebuiltLayers);
+                }
+            }
+
+            // all batches are drawn with the shared quad index buffer, so it has to fit the largest one
+            int32 MaxQuads = 0;
+            auto AccumulateMaxQuads = [&MaxQuads](const FBatchSet& Batches) {
+                for (int32 Group = 0; Group < NumBatchGroups; ++Group) {
+                    for (const FBatch* Batch : {Batches.LineBatches[Group], Batches.PointBatches[Group]}) {
+                        MaxQuads = Batch ? FMath::Max(MaxQuads, Batch->NumPrimitives) : MaxQuads;
+                    }
+                }
+            };
+            if (FrameVisibilityMap != 0) {
+                AccumulateMaxQuads(FrameBatches);
+            }
+            for (const TPair<int32, FRetainedLayer>& LayerPair : RetainedLayers) {
+                if (LayerPair.Value.bBatchesValid && GetLayerVisibilityMap(LayerPair.Value) != 0) {
+                    AccumulateMaxQuads(LayerPair.Value.Batches);
+                }
+            }
+            EnsureQuadIndices(MaxQuads, RHICmdList);
+        }
 
         for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++) {
-            if (VisibilityMap & (1 << ViewIndex)) {
-                const FSceneView* View = Views[ViewIndex];
-                FPrimitiveDrawInterface* PDI = Collector.GetPDI(ViewIndex);
-
-                int32 NumLines = Lines.Num(), NumPoints = Points.Num();
-                for (int32 k = 0; k < NumLines; ++k) {
-                    PDI->DrawLine(
-                        Lines[k].Start, Lines[k].End, Lines[k].Color, Lines[k].DepthPriorityGroup, Lines[k].Thickness,
-                        Lines[k].DepthBias, Lines[k].bScreenSpace
-                    );
+            const uint32 ViewBit = (1 << ViewIndex);
+            const FSceneView* View = Views[ViewIndex];
+            FPrimitiveDrawInterface* PDI = (VisibilityMap & ViewBit) ? Collector.GetPDI(ViewIndex) : nullptr;
+
+            if (FrameVisibilityMap & ViewBit) {
+                if (bBatched) {
+                    AddBatchSetToView(FrameBatches, View, ViewIndex, Collector);
+                }
+                if (bBatched == false || FrameBatches.NumUnbatchedLines > 0) {
+                    DrawUnbatched(PDI, Lines, Points, bBatched);
+                }
+            }
+
+            for (const TPair<int32, FRetainedLayer>& LayerPair : RetainedLayers) {
+                const FRetainedLayer& Layer = LayerPair.Value;
+                if ((GetLayerVisibilityMap(Layer) & ViewBit) == 0) {
+                    continue;
+                }
+                if (bBatched) {
+                    AddBatchSetToView(Layer.Batches, View, ViewIndex, Collector);
                 }
-                for (int32 k = 0; k < NumPoints; ++k) {
-                    PDI->DrawPoint(
-                        Points[k].Position, Points[k].Color, Points[k].PointSize, Points[k].DepthPriorityGroup
-                    );
+                if (bBatched == false || Layer.Batches.NumUnbatchedLines > 0) {
+                    DrawUnbatched(PDI, Layer.Geometry->Lines, Layer.Geometry->Points, bBatched);
                 }
             }
         }
     }
 
+    void AddBatchSetToView(
+        const FBatchSet& Batches, const FSceneView* View, int32 ViewIndex, FMeshElementCollector& Collector
+    ) const {
+        for (int32 Group = 0; Group < ToolsContextRenderLocals::NumBatchGroups; ++Group) {
+            AddBatchToView(Batches.LineBatches[Group], LineMaterials[Group], Group, View, ViewIndex, Collector);
+            AddBatchToView(Batches.PointBatches[Group], PointMaterials[Group], Group, View, ViewIndex, Collector);
+        }
+    }
+
+    // Count, allocate, fill and upload the batches for the given lines/points, reusing the Owned batches of each group
+    // (which are created on first use). Groups without any primitives are left null.
+    // @return number of lines that could not be batched
+    static int32 BuildBatches(
+        TArrayView<const UToolsContextRenderComponent::FPDILine> Lines,
+        TArrayView<const UToolsContextRenderComponent::FPDIPoint> Points, TUniquePtr<FBatch>* OwnedLineBatches,
+        TUniquePtr<FBatch>* OwnedPointBatches, FBatch** LineBatches, FBatch** PointBatches,
+        ERHIFeatureLevel::Type FeatureLevel, FRHICommandListBase& RHICmdList
+    ) {
+        using namespace ToolsContextRenderLocals;
+
+        int32 NumLines[NumBatchGroups] = {};
+        int32 NumPoints[NumBatchGroups] = {};
+        for (const UToolsContextRenderComponent::FPDILine& Line : Lines) {
+            NumLines[GetBatchGroup(Line.DepthPriorityGroup)] += CanBatchLine(Line) ? 1 : 0;
+        }
+        for (const UToolsContextRenderComponent::FPDIPoint& Point : Points) {
+            NumPoints[GetBatchGroup(Point.DepthPriorityGroup)]++;
+        }
+
+        auto GetBatch = [FeatureLevel](TUniquePtr<FBatch>& Owned) -> FBatch* {
+            if (Owned.IsValid() == false) {
+                Owned = MakeUnique<FBatch>(FeatureLevel);
+            }
+            return Owned.Get();
+        };
+
+        int32 NumUnbatchedLines = Lines.Num();
+        for (int32 Group = 0; Group < NumBatchGroups; ++Group) {
+            NumUnbatchedLines -= NumLines[Group];
+            LineBatches[Group] = nullptr;
+            PointBatches[Group] = nullptr;
+            if (NumLines[Group] > 0) {
+                LineBatches[Group] = GetBatch(OwnedLineBatches[Group]);
+                LineBatches[Group]->Allocate(NumLines[Group]);
+            }
+            if (NumPoints[Group] > 0) {
+                PointBatches[Group] = GetBatch(OwnedPointBatches[Group]);
+                PointBatches[Group]->Allocate(NumPoints[Group]);
+            }
+        }
+
+        for (const UToolsContextRenderComponent::FPDILine& Line : Lines) {
+            if (CanBatchLine(Line)) {
+                LineBatches[GetBatchGroup(Line.DepthPriorityGroup)]->AddLine(Line);
+            }
+        }
+        const int32 ParallelPointThreshold = CVarParallelPointThreshold.GetValueOnRenderThread();
+        if (ParallelPointThreshold > 0 && Points.Num() >= ParallelPointThreshold) {
+            WritePointsParallel(Points, PointBatches);
+        } else {
+            for (const UToolsContextRenderComponent::FPDIPoint& Point : Points) {
+                PointBatches[GetBatchGroup(Point.DepthPriorityGroup)]->AddPoint(Point);
+            }
+        }
+
+        for (int32 Group = 0; Group < NumBatchGroups; ++Group) {
+            if (LineBatches[Group]) {
+                LineBatches[Group]->UpdateResources(RHICmdList);
+            }
+            if (PointBatches[Group]) {
+                PointBatches[Group]->UpdateResources(RHICmdList);
+            }
+        }
+        return NumUnbatchedLines;
+    }
+
+    // Write the points into the (already allocated) batches of their groups, in parallel chunks. Each chunk first
+    // counts its points per group, so that it knows where to write them, in the same order as AddPoint() would.
+    static void WritePointsParallel(
+        TArrayView<const UToolsContextRenderComponent::FPDIPoint> Points, FBatch** PointBatches
+    ) {
+        using namespace ToolsContextRenderLocals;
+
+        const int32 NumChunks = FMath::DivideAndRoundUp(Points.Num(), PointChunkSize);
+        TArray<int32> ChunkOffsets;
+        ChunkOffsets.SetNumZeroed(NumChunks * NumBatchGroups);
+        TArray<FBox> ChunkBounds;
+        ChunkBounds.Init(FBox(ForceInit), NumChunks * NumBatchGroups);
+
+        ParallelFor(NumChunks, [&](int32 Chunk) {
+            const int32 End = FMath::Min((Chunk + 1) * PointChunkSize, Points.Num());
+            for (int32 k = Chunk * PointChunkSize; k < End; ++k) {
+                const int32 Slot = Chunk * NumBatchGroups + GetBatchGroup(Points[k].DepthPriorityGroup);
+                ChunkOffsets[Slot]++;
+                ChunkBounds[Slot] += Points[k].Position;
+            }
+        });
+
+        // turn the per-chunk counts into per-chunk start offsets
+        for (int32 Group = 0; Group < NumBatchGroups; ++Group) {
+            int32 Offset = 0;
+            for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk) {
+                const int32 Slot = Chunk * NumBatchGroups + Group;
+                const int32 Count = ChunkOffsets[Slot];
+                ChunkOffsets[Slot] = Offset;
+                Offset += Count;
+                if (PointBatches[Group]) {
+                    PointBatches[Group]->Bounds += ChunkBounds[Slot];
+                }
+            }
+            if (PointBatches[Group]) {
+                PointBatches[Group]->NumPrimitives = Offset;
+            }
+        }
+
+        ParallelFor(NumChunks, [&](int32 Chunk) {
+            int32 NextQuad[NumBatchGroups];
+            for (int32 Group = 0; Group < NumBatchGroups; ++Group) {
+                NextQuad[Group] = ChunkOffsets[Chunk * NumBatchGroups + Group];
+            }
+            const int32 End = FMath::Min((Chunk + 1) * PointChunkSize, Points.Num());
+            for (int32 k = Chunk * PointChunkSize; k < End; ++k) {
+                const int32 Group = GetBatchGroup(Points[k].DepthPriorityGroup);
+                PointBatches[Group]->WritePoint(NextQuad[Group]++, Points[k]);
+            }
+        });
+    }
+
+    // grow SharedQuadIndices so that it covers at least NumQuads quads
+    void EnsureQuadIndices(int32 NumQuads, FRHICommandListBase& RHICmdList) const {
+        if (NumQuads <= NumSharedQuads) {
+            return;
+        }
+
+        const int32 NewNumQuads = FMath::Max(1024, static_cast<int32>(FMath::RoundUpToPowerOfTwo(NumQuads)));
+        SharedQuadIndices.ReleaseResource();
+        SharedQuadIndices.Indices.SetNumUninitialized(6 * NewNumQuads);
+        uint32* Indices = SharedQuadIndices.Indices.GetData();
+        for (uint32 Quad = 0, V = 0; Quad < static_cast<uint32>(NewNumQuads); ++Quad, V += 4) {
+            *Indices++ = V + 0;
+            *Indices++ = V + 1;
+            *Indices++ = V + 2;
+            *Indices++ = V + 2;
+            *Indices++ = V + 3;
+            *Indices++ = V + 0;
+        }
+        SharedQuadIndices.InitResource(RHICmdList);
+
+        // the GPU copy is all that is needed
+        SharedQuadIndices.Indices.Empty();
+        NumSharedQuads = NewNumQuads;
+    }
+
+    // draw the lines that are not in a batch (or all lines and points, if not batched) through the PDI
+    static void DrawUnbatched(
+        FPrimitiveDrawInterface* PDI, TArrayView<const UToolsContextRenderComponent::FPDILine> Lines,
+        TArrayView<const UToolsContextRenderComponent::FPDIPoint> Points, bool bBatched
+    ) {
+        for (const UToolsContextRenderComponent::FPDILine& Line : Lines) {
+            if (bBatched && ToolsContextRenderLocals::CanBatchLine(Line)) {
+                continue;
+            }
+            INC_DWORD_STAT(STAT_RuntimeTools_PDIPrimitives);
+            PDI->DrawLine(
+                Line.Start, Line.End, Line.Color, Line.DepthPriorityGroup, Line.Thickness, Line.DepthBias,
+                Line.bScreenSpace
+            );
+        }
+        if (bBatched == false) {
+            INC_DWORD_STAT_BY(STAT_RuntimeTools_PDIPrimitives, Points.Num());
+            for (const UToolsContextRenderComponent::FPDIPoint& Point : Points) {
+                PDI->DrawPoint(Point.Position, Point.Color, Point.PointSize, Point.DepthPriorityGroup);
+            }
+        }
+    }
+
+    void AddBatchToView(
+        const FToolsContextPrimitiveBatch* Batch, UMaterialInterface* Material, int32 Group, const FSceneView* View,
+        int32 ViewIndex, FMeshElementCollector& Collector
+    ) const {
+        if (Batch == nullptr) {
+            return;
+        }
+
+        if (ToolsContextRenderLocals::IsBoxInView(View, Batch->Bounds) == false) {
+            return;
+        }
+
+        INC_DWORD_STAT_BY(STAT_RuntimeTools_BatchedPrimitives, Batch->NumPrimitives);
+
+        FMeshBatch& Mesh = Collector.AllocateMesh();
+        Mesh.VertexFactory = &Batch->VertexFactory;
+        Mesh.MaterialRenderProxy = Material->GetRenderProxy();
+        Mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+        Mesh.Type = PT_TriangleList;
+        Mesh.DepthPriorityGroup = (Group == 1) ? SDPG_Foreground : SDPG_World;
+        Mesh.bCanApplyViewModeOverrides = false;
+        Mesh.bWireframe = false;
+
+        FMeshBatchElement& BatchElement = Mesh.Elements[0];
+        BatchElement.IndexBuffer = &SharedQuadIndices;
+        BatchElement.FirstIndex = 0;
+        BatchElement.NumPrimitives = 2 * Batch->NumPrimitives;
+        BatchElement.MinVertexIndex = 0;
+        BatchElement.MaxVertexIndex = 4 * Batch->NumPrimitives - 1;
+
+        FDynamicPrimitiveUniformBuffer& DynamicPrimitiveUniformBuffer =
+            Collector.AllocateOneFrameResource<FDynamicPrimitiveUniformBuffer>();
+        DynamicPrimitiveUniformBuffer.Set(
+            Collector.GetRHICommandList(), GetLocalToWorld(), GetLocalToWorld(), GetBounds(), GetLocalBounds(), true,
+            false, AlwaysHasVelocity()
+        );
+        BatchElement.PrimitiveUniformBufferResource = &DynamicPrimitiveUniformBuffer.UniformBuffer;
+
+        Collector.AddMesh(ViewIndex, Mesh);
+    }
+
     virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override {
         FPrimitiveViewRelevance Result;
         Result.bDrawRelevance = IsShown(View);
@@ -58,6 +692,7 @@ public:
         Result.bShadowRelevance = false;
         Result.bEditorPrimitiveRelevance = UseEditorCompositing(View);
         Result.bRenderCustomDepth = ShouldRenderCustomDepth();
+        MaterialRelevance.SetPrimitiveViewRelevance(Result);
         return Result;
     }
 
@@ -74,10 +709,26 @@ public:
     }
 
 
-    // set to lambda that steals current lines/points from the Component
-    TUniqueFunction<
-        void(TArray<UToolsContextRenderComponent::FPDILine>&, TArray<UToolsContextRenderComponent::FPDIPoint>&)>
-        GetGeometryQueryFunc;
+    // set to lambda that acquires the latest published frame from the Component
+    TUniqueFunction<const UToolsContextRenderComponent::FGeometryFrame&()> GetGeometryQueryFunc;
+
+    // batches of the published frame, and the frame they were built from. Render thread only.
+    mutable FBatchSet FrameBatches;
+    mutable const UToolsContextRenderComponent::FGeometryFrame* FrameBatchesSource = nullptr;
+    mutable uint64 FrameBatchesFrameNumber = 0;
+
+    // retained layers, only accessed on the render thread (batches are rebuilt lazily in GetDynamicMeshElements)
+    mutable TMap<int32, FRetainedLayer> RetainedLayers;
+
+    // indices for NumSharedQuads quads of 4 consecutive vertices each, shared by all batches. Render thread only.
+    mutable FDynamicMeshIndexBuffer32 SharedQuadIndices;
+    mutable int32 NumSharedQuads = 0;
+
+    // batch materials, indexed by depth-priority group
+    UMaterialInterface* LineMaterials[ToolsContextRenderLocals::NumBatchGroups] = {};
+    UMaterialInterface* PointMaterials[ToolsContextRenderLocals::NumBatchGroups] = {};
+    bool bHaveBatchMaterials = false;
+    FMaterialRelevance MaterialRelevance;
 };
 
 
@@ -105,7 +756,7 @@ public:
     virtual void AddReserveLines(
         uint8 DepthPriorityGroup, int32 NumLines, bool bDepthBiased = false, bool bThickLines = false
     ) override {
-        ensure(false);
+        RenderComponent->ReserveLines(NumLines);
     }
     virtual int32 DrawMesh(const FMeshBatch& Mesh) override {
         ensure(false);
@@ -147,32 +798,273 @@ TSharedPtr<FPrimitiveDrawInterface> UToolsContextRenderComponent::GetPDIForView(
 
 
 
+uint32 UToolsContextRenderComponent::AllocateAccumulationEpoch() {
+    static std::atomic<uint32> EpochCounter{0};
+    return ++EpochCounter;
+}
+
+
+UToolsContextRenderComponent::FThreadGeometryBuffer& UToolsContextRenderComponent::GetThreadBuffer() {
+    if (IsInGameThread()) {
+        return GameThreadBuffer;
+    }
+
+    // Each thread remembers the buffers it registered, keyed by the globally-unique epoch of the component frame they
+    // were registered in. So after PublishFrame() (or for a different component) the cached entries simply do not
+    // match anymore, and only the first draw per thread per frame has to take the lock.
+    struct FCachedBuffer {
+        uint32 Epoch;
+        FThreadGeometryBuffer* Buffer;
+    };
+    static thread_local TArray<FCachedBuffer, TInlineAllocator<4>> CachedBuffers;
+
+    const uint32 Epoch = AccumulationEpoch.load(std::memory_order_acquire);
+    for (const FCachedBuffer& Cached : CachedBuffers) {
+        if (Cached.Epoch == Epoch) {
+            return *Cached.Buffer;
+        }
+    }
+
+    FThreadGeometryBuffer* NewBuffer;
+    {
+        FScopeLock Lock(&WorkerThreadBuffersLock);
+        TUniquePtr<FThreadGeometryBuffer> Buffer =
+            (FreeWorkerThreadBuffers.Num() > 0) ? FreeWorkerThreadBuffers.Pop() : MakeUnique<FThreadGeometryBuffer>();
+        NewBuffer = WorkerThreadBuffers.Add_GetRef(MoveTemp(Buffer)).Get();
+    }
+
+    if (CachedBuffers.Num() == 4) {
+        CachedBuffers.RemoveAt(0);
+    }
+    CachedBuffers.Add(FCachedBuffer{Epoch, NewBuffer});
+    return *NewBuffer;
+}
+
+
 void UToolsContextRenderComponent::DrawLine(
     const FVector& Start, const FVector& End, const FLinearColor& Color, uint8 DepthPriorityGroupIn, float Thickness,
     float DepthBias, bool bScreenSpace
 ) {
-    GeometryLock.Lock();
-    CurrentLines.Add(FPDILine{Start, End, Color, DepthPriorityGroupIn, Thickness, DepthBias, bScreenSpace});
-    GeometryLock.Unlock();
+    GetThreadBuffer().Lines.Add(FPDILine{Start, End, Color, DepthPriorityGroupIn, Thickness, DepthBias, bScreenSpace});
 }
 
 void UToolsContextRenderComponent::DrawPoint(
     const FVector& Position, const FLinearColor& Color, float PointSize, uint8 DepthPriorityGroupIn
 ) {
-    GeometryLock.Lock();
-    CurrentPoints.Add(FPDIPoint{Position, Color, PointSize, DepthPriorityGroupIn});
-    GeometryLock.Unlock();
+    GetThreadBuffer().Points.Add(FPDIPoint{Position, Color, PointSize, DepthPriorityGroupIn});
+}
+
+void UToolsContextRenderComponent::DrawLines(TArrayView<const FPDILine> Lines) {
+    GetThreadBuffer().Lines.Append(Lines.GetData(), Lines.Num());
+}
+
+void UToolsContextRenderComponent::DrawPoints(TArrayView<const FPDIPoint> Points) {
+    GetThreadBuffer().Points.Append(Points.GetData(), Points.Num());
+}
+
+void UToolsContextRenderComponent::ReserveLines(int32 NumLines) {
+    TArray<FPDILine>& Lines = GetThreadBuffer().Lines;
+    Lines.Reserve(Lines.Num() + NumLines);
+}
+
+void UToolsContextRenderComponent::ReservePoints(int32 NumPoints) {
+    TArray<FPDIPoint>& Points = GetThreadBuffer().Points;
+    Points.Reserve(Points.Num() + NumPoints);
 }
 
 
-TUniqueFunction<void(TArray<UToolsContextRenderComponent::FPDILine>&, TArray<UToolsContextRenderComponent::FPDIPoint>&)>
+void UToolsContextRenderComponent::PublishFrame() {
+    check(IsInGameThread());
+
+    // Swap the game-thread arrays into the recycled frame, and keep the frame's old arrays (emptied) for accumulating
+    // the next frame. So the arrays circulate with their capacity, and do not have to grow again every frame.
+    FGeometryFrame* NewFrame = &Mailbox->Frames[Mailbox->WriteFrame];
+    NewFrame->FrameNumber = GFrameCounter;
+    NewFrame->Bounds = FBox(ForceInit);
+    Swap(NewFrame->Lines, GameThreadBuffer.Lines);
+    Swap(NewFrame->Points, GameThreadBuffer.Points);
+    GameThreadBuffer.Lines.Reset();
+    GameThreadBuffer.Points.Reset();
+
+    {
+        FScopeLock Lock(&WorkerThreadBuffersLock);
+        for (TUniquePtr<FThreadGeometryBuffer>& Buffer : WorkerThreadBuffers) {
+            NewFrame->Lines.Append(Buffer->Lines);
+            NewFrame->Points.Append(Buffer->Points);
+            Buffer->Lines.Reset();
+            Buffer->Points.Reset();
+            FreeWorkerThreadBuffers.Add(MoveTemp(Buffer));
+        }
+        WorkerThreadBuffers.Reset();
+        AccumulationEpoch.store(AllocateAccumulationEpoch(), std::memory_order_release);
+    }
+
+    for (const FPDILine& Line : NewFrame->Lines) {
+        NewFrame->Bounds += Line.Start;
+        NewFrame->Bounds += Line.End;
+    }
+    for (const FPDIPoint& Point : NewFrame->Points) {
+        NewFrame->Bounds += Point.Position;
+    }
+    SET_DWORD_STAT(STAT_RuntimeTools_PublishedLines, NewFrame->Lines.Num());
+    SET_DWORD_STAT(STAT_RuntimeTools_PublishedPoints, NewFrame->Points.Num());
+    SET_DWORD_STAT(STAT_RuntimeTools_OverlayLayers, OverlayLayers.Num());
+
+    UpdatePublishedBounds(NewFrame->Bounds);
+
+    // if the SceneProxy did not pick up the previous frame, it is simply replaced (and recycled)
+    Mailbox->Publish();
+}
+
+
+void UToolsContextRenderComponent::UpdatePublishedBounds(const FBox& FrameBounds) {
+    FBox ContentBounds = FrameBounds;
+    for (const TPair<int32, FOverlayLayer>& Layer : OverlayLayers) {
+        if (Layer.Value.bVisible && Layer.Value.Geometry.IsValid()) {
+            ContentBounds += Layer.Value.Geometry->Bounds;
+        }
+    }
+
+    // The SceneProxy picks up published frames directly, but only receives new bounds with the next render transform
+    // update. So it may draw the previous frame with these bounds (keep covering it), or the next one (leave room for
+    // it to grow as much as this one did since the previous frame).
+    FBox NewBounds = ContentBounds;
+    if (ContentBounds.IsValid && LastContentBounds.IsValid) {
+        const FVector Growth = FVector::Max(
+            FVector::Max(ContentBounds.Max - LastContentBounds.Max, LastContentBounds.Min - ContentBounds.Min),
+            FVector::ZeroVector
+        );
+        NewBounds = (ContentBounds + LastContentBounds).ExpandBy(Growth);
+    } else if (LastContentBounds.IsValid) {
+        NewBounds = LastContentBounds;
+    }
+    LastContentBounds = ContentBounds;
+
+    if (NewBounds != PublishedBounds) {
+        PublishedBounds = NewBounds;
+        UpdateBounds();
+        MarkRenderTransformDirty();
+    }
+}
+
+
+TUniqueFunction<const UToolsContextRenderComponent::FGeometryFrame&()>
 UToolsContextRenderComponent::MakeGetCurrentGeometryQueryFunc() {
-    return [this](TArray<FPDILine>& LineStorage, TArray<FPDIPoint>& PointStorage) {
-        GeometryLock.Lock();
-        LineStorage = MoveTemp(CurrentLines);
-        PointStorage = MoveTemp(CurrentPoints);
-        GeometryLock.Unlock();
-    };
+    return [Mailbox = this->Mailbox]() -> const FGeometryFrame& { return Mailbox->AcquireLatest(); };
+}
+
+int32 UToolsContextRenderComponent::CreateOverlayLayer() {
+    check(IsInGameThread());
+    const int32 LayerID = NextOverlayLayerID++;
+    OverlayLayers.Add(LayerID, FOverlayLayer());
+    return LayerID;
+}
+
+void UToolsContextRenderComponent::SetOverlayLayerLines(int32 LayerID, TArray<FPDILine> Lines) {
+    const FOverlayLayer* Layer = OverlayLayers.Find(LayerID);
+    TArray<FPDIPoint> Points = (Layer && Layer->Geometry) ? Layer->Geometry->Points : TArray<FPDIPoint>();
+    SetOverlayLayerGeometry(LayerID, MoveTemp(Lines), MoveTemp(Points));
+}
+
+void UToolsContextRenderComponent::SetOverlayLayerPoints(int32 LayerID, TArray<FPDIPoint> Points) {
+    const FOverlayLayer* Layer = OverlayLayers.Find(LayerID);
+    TArray<FPDILine> Lines = (Layer && Layer->Geometry) ? Layer->Geometry->Lines : TArray<FPDILine>();
+    SetOverlayLayerGeometry(LayerID, MoveTemp(Lines), MoveTemp(Points));
+}
+
+void UToolsContextRenderComponent::SetOverlayLayerGeometry(
+    int32 LayerID, TArray<FPDILine> Lines, TArray<FPDIPoint> Points
+) {
+    TSharedPtr<FOverlayLayerGeometry, ESPMode::ThreadSafe> Geometry =
+        MakeShared<FOverlayLayerGeometry, ESPMode::ThreadSafe>();
+    Geometry->Lines = MoveTemp(Lines);
+    Geometry->Points = MoveTemp(Points);
+    for (const FPDILine& Line : Geometry->Lines) {
+        Geometry->Bounds += Line.Start;
+        Geometry->Bounds += Line.End;
+    }
+    for (const FPDIPoint& Point : Geometry->Points) {
+        Geometry->Bounds += Point.Position;
+    }
+    SetOverlayLayerGeometryInternal(LayerID, MoveTemp(Geometry));
+}
+
+void UToolsContextRenderComponent::SetOverlayLayerGeometryInternal(
+    int32 LayerID, TSharedPtr<const FOverlayLayerGeometry, ESPMode::ThreadSafe> Geometry
+) {
+    check(IsInGameThread());
+    FOverlayLayer* Layer = OverlayLayers.Find(LayerID);
+    if (!ensureMsgf(Layer, TEXT("SetOverlayLayerGeometry: invalid layer %d"), LayerID)) {
+        return;
+    }
+    Layer->Geometry = MoveTemp(Geometry);
+    SendOverlayLayerToProxy(LayerID);
+}
+
+void UToolsContextRenderComponent::SetOverlayLayerVisible(int32 LayerID, bool bVisible) {
+    check(IsInGameThread());
+    FOverlayLayer* Layer = OverlayLayers.Find(LayerID);
+    if (ensureMsgf(Layer, TEXT("SetOverlayLayerVisible: invalid layer %d"), LayerID) && Layer->bVisible != bVisible) {
+        Layer->bVisible = bVisible;
+        SendOverlayLayerToProxy(LayerID);
+    }
+}
+
+void UToolsContextRenderComponent::DestroyOverlayLayer(int32 LayerID) {
+    check(IsInGameThread());
+    if (OverlayLayers.Remove(LayerID) > 0) {
+        SendOverlayLayerToProxy(LayerID);
+    }
+}
+
+bool UToolsContextRenderComponent::IsValidOverlayLayer(int32 LayerID) const {
+    return OverlayLayers.Contains(LayerID);
+}
+
+void UToolsContextRenderComponent::SendOverlayLayerToProxy(int32 LayerID) {
+    FToolsContextRenderComponentSceneProxy* Proxy = static_cast<FToolsContextRenderComponentSceneProxy*>(SceneProxy);
+    if (Proxy == nullptr) {
+        // CreateSceneProxy() passes all layers to the new proxy
+        return;
+    }
+
+    const FOverlayLayer* Layer = OverlayLayers.Find(LayerID);
+    FToolsContextRenderComponentSceneProxy::FLayerGeometryPtr Geometry;
+    bool bVisible = false;
+    if (Layer) {
+        Geometry = Layer->Geometry;
+        bVisible = Layer->bVisible;
+    }
+    if (Layer && Geometry.IsValid() == false) {
+        // layer without any geometry yet, nothing to draw
+        return;
+    }
+
+    ENQUEUE_RENDER_COMMAND(UpdateToolsContextOverlayLayer)
+    ([Proxy, LayerID, Geometry, bVisible](FRHICommandListImmediate& RHICmdList) {
+        Proxy->SetOverlayLayer(LayerID, Geometry, bVisible);
+    });
+}
+
+
+void UToolsContextRenderComponent::OnRegister() {
+    Super::OnRegister();
+
+    if (LineMaterial == nullptr) {
+        LineMaterial = ToolSetupUtil::GetDefaultLineComponentMaterial(nullptr, true);
+        OverlaidLineMaterial = ToolSetupUtil::GetDefaultLineComponentMaterial(nullptr, false);
+        PointMaterial = ToolSetupUtil::GetDefaultPointComponentMaterial(nullptr, true);
+        OverlaidPointMaterial = ToolSetupUtil::GetDefaultPointComponentMaterial(nullptr, false);
+    }
+}
+
+void UToolsContextRenderComponent::GetUsedMaterials(TArray<UMaterialInterface*>& OutMaterials, bool bGetDebugMaterials)
+    const {
+    for (UMaterialInterface* Material : {LineMaterial, OverlaidLineMaterial, PointMaterial, OverlaidPointMaterial}) {
+        if (Material) {
+            OutMaterials.Add(Material);
+        }
+    }
 }
 
 FPrimitiveSceneProxy* UToolsContextRenderComponent::CreateSceneProxy() {
@@ -188,7 +1080,9 @@ bool UToolsContextRenderComponent::LineTraceComponent(
 
 
 FBoxSphereBounds UToolsContextRenderComponent::CalcBounds(const FTransform& LocalToWorld) const {
-    // infinite bounds. TODO: accumulate actual bounds? will result in unstable depth sorting...
-    float f = 9999999.0f;
-    return FBoxSphereBounds(FBox(-FVector(f, f, f), FVector(f, f, f)));
-}
\ No newline at end of file
+    // bounds of the published frames and visible layers, padded in UpdatePublishedBounds()
+    if (PublishedBounds.IsValid == false) {
+        return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.0);
+    }
+    return FBoxSphereBounds(PublishedBounds.TransformBy(LocalToWorld));
+}
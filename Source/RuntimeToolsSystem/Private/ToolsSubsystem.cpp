@@ -6,6 +6,7 @@
 #include "Slate/SceneViewport.h"
 #include "Slate/SGameLayerManager.h"
 #include "Engine/LocalPlayer.h"
+#include "Engine/GameInstance.h"
 #include "GameFramework/PlayerController.h"
 #include "ContextObjectStore.h"
 #include "MaterialDomain.h"
@@ -17,6 +18,19 @@
 #include "BaseGizmos/TransformGizmoUtil.h"
 #include "BaseGizmos/GizmoViewContext.h"
 #include "RuntimeToolsFramework/RuntimeModelingObjectsCreationAPI.h"
+#include "RuntimeToolsStats.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("Tools Tick"), STAT_RuntimeTools_Tick, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("Tools Tick (Idle)"), STAT_RuntimeTools_IdleTick, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("Tools Update View"), STAT_RuntimeTools_UpdateView, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("Tools Input Routing"), STAT_RuntimeTools_InputRouting, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("Compute Scheduler Tick"), STAT_RuntimeTools_ComputeScheduler, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("Collision Updater Tick"), STAT_RuntimeTools_CollisionUpdater, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("ToolManager Tick"), STAT_RuntimeTools_ToolManagerTick, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("GizmoManager Tick"), STAT_RuntimeTools_GizmoManagerTick, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("Tools Render"), STAT_RuntimeTools_Render, STATGROUP_RuntimeTools);
+DECLARE_CYCLE_STAT(TEXT("Tools Publish Frame"), STAT_RuntimeTools_PublishFrame, STATGROUP_RuntimeTools);
 
 
 
@@ -159,6 +173,10 @@ UToolsSubsystem* UToolsSubsystem::Get() {
     return InstanceSingleton;
 }
 
+UToolsSubsystem* UToolsSubsystem::TryGet() {
+    return InstanceSingleton;
+}
+
 
 void UToolsSubsystem::Deinitialize() {
     ShutdownToolsContext();
@@ -190,6 +208,16 @@ void UToolsSubsystem::InitializeToolsContext(UWorld* TargetWorldIn) {
     SceneHistory->OnHistoryStateChange.AddUObject(this, &UToolsSubsystem::OnSceneHistoryStateChange);
 
 
+    // create scheduler for Tool background computations
+    ComputeScheduler = NewObject<URuntimeToolComputeScheduler>(this);
+
+    // create deferred collision updates for edited meshes
+    CollisionUpdater = NewObject<URuntimeCollisionUpdater>(this);
+
+    // split the render buffers of edited meshes, so that region edits only re-upload the chunks they touch
+    RenderChunkUpdater = NewObject<URuntimeRenderChunkUpdater>(this);
+
+
     // register selection interaction
     SelectionInteraction = NewObject<USceneObjectSelectionInteraction>();
     SelectionInteraction->Initialize([this]() { return HaveActiveTool() == false; });
@@ -217,7 +245,13 @@ void UToolsSubsystem::InitializeToolsContext(UWorld* TargetWorldIn) {
 
     // register target factory for dynamic mesh components
     // ToolsContext->TargetManager->AddTargetFactory(NewObject<URuntimeDynamicMeshComponentToolTargetFactory>(ToolsContext->ToolManager));
-    ToolsContext->TargetManager->AddTargetFactory(NewObject<URuntimeDynamicMeshComponentToolTargetFactory>(this));
+    TargetFactory = NewObject<URuntimeDynamicMeshComponentToolTargetFactory>(this);
+    ToolsContext->TargetManager->AddTargetFactory(TargetFactory);
+
+    // selection changes affect the gizmos, so the next Tick() cannot be skipped
+    SelectionChangedEventHandle = UMeshSceneSubsystem::Get()->OnSelectionModified.AddLambda(
+        [this](UMeshSceneSubsystem* SceneSubsystem) { bTickStateDirty = true; }
+    );
 
     // register transform gizmo util helper
     UE::TransformGizmoUtil::RegisterTransformGizmoContextObject(ToolsContext);
@@ -244,6 +278,16 @@ void UToolsSubsystem::ShutdownToolsContext() {
         ToolsContext->Shutdown();
     }
 
+    if (SelectionChangedEventHandle.IsValid()) {
+        if (UMeshSceneSubsystem::Get()) {
+            UMeshSceneSubsystem::Get()->OnSelectionModified.Remove(SelectionChangedEventHandle);
+        }
+        SelectionChangedEventHandle = FDelegateHandle();
+    }
+
+    CachedView.SceneView = nullptr;
+    CachedView.ViewFamily.Reset();
+
     // get rid of the PDI rendering helper Actor
     if (PDIRenderActor) {
         PDIRenderActor->Destroy();
@@ -260,6 +304,15 @@ void UToolsSubsystem::ShutdownToolsContext() {
 
     SelectionInteraction = nullptr;
     TransformInteraction = nullptr;
+    ComputeScheduler = nullptr;
+
+    // the collision of the last edits would otherwise never be rebuilt
+    if (CollisionUpdater) {
+        CollisionUpdater->FlushCollisionUpdates();
+    }
+    CollisionUpdater = nullptr;
+    RenderChunkUpdater = nullptr;
+    TargetFactory = nullptr;
 
     bIsShuttingDown = false;
 }
@@ -270,15 +323,19 @@ void UToolsSubsystem::OnToolStarted(UInteractiveToolManager* Manager, UInteracti
     AddAllPropertySetKeepalives(Tool);
 
     TransformInteraction->ForceUpdateGizmoState();
+    bTickStateDirty = true;
 }
 
 void UToolsSubsystem::OnToolEnded(UInteractiveToolManager* Manager, UInteractiveTool* Tool) {
+    bTickStateDirty = true;
+    ComputeScheduler->UnregisterTool(Tool);
     if (!bIsShuttingDown) {
         TransformInteraction->ForceUpdateGizmoState();
     }
 }
 
 void UToolsSubsystem::OnSceneHistoryStateChange() {
+    bTickStateDirty = true;
     if (!bIsShuttingDown) {
         TransformInteraction->ForceUpdateGizmoState();
     }
@@ -324,12 +381,20 @@ public:
 
 
 
-UE_DISABLE_OPTIMIZATION
 void UToolsSubsystem::Tick(float DeltaTime) {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_Tick);
+
     if (ensure(ContextActor) == false) {
         return;
     }
 
+    // also in idle ticks, the collision update delay runs out without any input
+    {
+        RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_CollisionUpdater);
+        CollisionUpdater->Tick();
+    }
+    RenderChunkUpdater->Tick();
+
     // no longer exists...
     // GizmoRenderingUtil::SetGlobalFocusedEditorSceneView(nullptr);
 
@@ -358,110 +423,250 @@ void UToolsSubsystem::Tick(float DeltaTime) {
     if (ViewportClient) {
         FSceneViewport* Viewport = ViewportClient->GetGameViewport();
 
-        FEngineShowFlags* ShowFlags = ViewportClient->GetEngineShowFlags();
-        FSceneViewFamilyContext ViewFamily(
-            FSceneViewFamily::ConstructionValues(ViewportClient->Viewport, TargetWorld->Scene, *ShowFlags)
-                .SetRealtimeUpdate(true)
+        FTickInputState TickInputState;
+        // keep routing to the same view while a drag is in progress, even if the mouse leaves its split-screen area
+        TickInputState.LocalPlayer = (IsCapturingMouse() && LastTickInputState.LocalPlayer.IsValid())
+                                         ? LastTickInputState.LocalPlayer
+                                         : FindInputLocalPlayer(ViewportClient, ViewportMousePos);
+        if (TickInputState.LocalPlayer.IsValid() == false) {
+            return;
+        }
+        TickInputState.MousePosition = ViewportMousePos;
+        TickInputState.LocalPlayer->PlayerController->GetPlayerViewPoint(
+            TickInputState.ViewLocation, TickInputState.ViewRotation
         );
+        TickInputState.ViewportSize = ViewportClient->Viewport->GetSizeXY();
+        TickInputState.bShiftDown = ModifierState.IsLeftShiftDown();
+        TickInputState.bAltDown = ModifierState.IsAltDown();
+        TickInputState.bControlDown = ModifierState.IsControlDown();
+        TickInputState.bCommandDown = ModifierState.IsCommandDown();
+
+        if (CanSkipIdleTick(TickInputState)) {
+            // the view, ray and hover state would be the same as last tick, and the render component keeps
+            // drawing the last published frame
+            RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_IdleTick);
+            ToolsContext->ToolManager->Tick(DeltaTime);
+            ToolsContext->GizmoManager->Tick(DeltaTime);
+            return;
+        }
 
-        ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(ContextActor->PlayerController->Player);
-        FVector ViewLocation;
-        FRotator ViewRotation;
-        FSceneView* SceneView = LocalPlayer->CalcSceneView(
-            &ViewFamily, /*out*/ ViewLocation, /*out*/ ViewRotation, LocalPlayer->ViewportClient->Viewport
-        );
+        // cleared before routing input, so that anything changed by this tick makes the next one a full tick too
+        LastTickInputState = TickInputState;
+        bTickStateDirty = false;
+
+        const FSceneView* SceneView;
+        {
+            RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_UpdateView);
+            SceneView = UpdateCachedSceneView(ViewportClient, TickInputState);
+        }
         if (SceneView == nullptr) {
             return;  // abort abort
         }
 
-        UGizmoViewContext* GizmoViewContext = ToolsContext->ContextObjectStore->FindContext<UGizmoViewContext>();
-        if (GizmoViewContext) {
-            GizmoViewContext->ResetFromSceneView(*SceneView);
+        ContextQueriesAPI->UpdateActiveViewport(Viewport);
+
+        RouteMouseInput(InputState, ViewportMousePos, SceneView);
+
+        // tick things
+        {
+            RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_ComputeScheduler);
+            ComputeScheduler->Tick(GetActiveTool());
+        }
+        {
+            RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_ToolManagerTick);
+            ToolsContext->ToolManager->Tick(DeltaTime);
+        }
+        {
+            RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_GizmoManagerTick);
+            ToolsContext->GizmoManager->Tick(DeltaTime);
         }
 
-        ContextQueriesAPI->UpdateActiveViewport(Viewport);
+        // render things, for the input view only (see Tick() in the header)
+        {
+            RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_Render);
+            FRuntimeToolsFrameworkRenderImpl RenderAPI(PDIRenderComponent, SceneView, CurrentViewCameraState);
+            ToolsContext->ToolManager->Render(&RenderAPI);
+            ToolsContext->GizmoManager->Render(&RenderAPI);
+        }
 
-        CurrentViewCameraState.Position = ViewLocation;
-        CurrentViewCameraState.Orientation = ViewRotation.Quaternion();
-        CurrentViewCameraState.HorizontalFOVDegrees = SceneView->FOV;
-        CurrentViewCameraState.AspectRatio = Viewport->GetDesiredAspectRatio();  // ViewportClient->AspectRatio;
-        CurrentViewCameraState.bIsOrthographic = false;
-        CurrentViewCameraState.bIsVR = false;
-        CurrentViewCameraState.OrthoWorldCoordinateWidth = 1;
-
-        FVector4 ScreenPos = SceneView->PixelToScreen(ViewportMousePos.X, ViewportMousePos.Y, 0);
-
-        const FMatrix InvViewMatrix = SceneView->ViewMatrices.GetInvViewMatrix();
-        const FMatrix InvProjMatrix = SceneView->ViewMatrices.GetInvProjectionMatrix();
-
-        const float ScreenX = ScreenPos.X;
-        const float ScreenY = ScreenPos.Y;
-
-        FVector Origin;
-        FVector Direction;
-        if (!ViewportClient->IsOrtho()) {
-            Origin = SceneView->ViewMatrices.GetViewOrigin();
-            Direction = InvViewMatrix
-                            .TransformVector(FVector(InvProjMatrix.TransformFVector4(FVector4(
-                                ScreenX * GNearClippingPlane, ScreenY * GNearClippingPlane, 0.0f, GNearClippingPlane
-                            ))))
-                            .GetSafeNormal();
-        } else {
-            Origin =
-                InvViewMatrix.TransformFVector4(InvProjMatrix.TransformFVector4(FVector4(ScreenX, ScreenY, 0.5f, 1.0f))
-                );
-            Direction = InvViewMatrix.TransformVector(FVector(0, 0, 1)).GetSafeNormal();
+        // hand the accumulated PDI lines over to the render thread
+        {
+            RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_PublishFrame);
+            PDIRenderComponent->PublishFrame();
         }
+    }
+}
 
-        // fudge factor so we don't hit actor...
-        Origin += 1.0 * Direction;
 
-        InputState.Mouse.Position2D = ViewportMousePos;
-        InputState.Mouse.Delta2D = CurrentMouseState.Mouse.Position2D - PrevMousePosition;
-        PrevMousePosition = InputState.Mouse.Position2D;
-        InputState.Mouse.WorldRay = FRay(Origin, Direction);
+void UToolsSubsystem::RouteMouseInput(
+    FInputDeviceState& InputState, const FVector2D& ViewportMousePos, const FSceneView* SceneView
+) {
+    RUNTIMETOOLS_SCOPE_CYCLE_COUNTER(STAT_RuntimeTools_InputRouting);
 
+    // PixelToScreen() expects coordinates relative to the view rect, which is offset in split-screen
+    const FVector2D ViewMousePos = ViewportMousePos - FVector2D(SceneView->UnscaledViewRect.Min);
+    FVector4 ScreenPos = SceneView->PixelToScreen(ViewMousePos.X, ViewMousePos.Y, 0);
 
-        // if we are in camera control we don't send any events
-        bool bInCameraControl = (ContextActor->GetCurrentInteractionMode() != EToolActorInteractionMode::NoInteraction);
-        if (bInCameraControl) {
-            ensure(bPendingMouseStateChange == false);
-            ensure(ToolsContext->InputRouter->HasActiveMouseCapture() == false);
-            // ToolsContext->InputRouter->PostHoverInputEvent(InputState);
-        } else if (bPendingMouseStateChange || ToolsContext->InputRouter->HasActiveMouseCapture()) {
-            ToolsContext->InputRouter->PostInputEvent(InputState);
-        } else {
+    const FMatrix& InvViewMatrix = CachedView.InvViewMatrix;
+    const FMatrix& InvProjMatrix = CachedView.InvProjectionMatrix;
+
+    const float ScreenX = ScreenPos.X;
+    const float ScreenY = ScreenPos.Y;
+
+    FVector Origin;
+    FVector Direction;
+    if (!CachedView.bIsOrtho) {
+        Origin = CachedView.ViewOrigin;
+        Direction = InvViewMatrix
+                        .TransformVector(FVector(InvProjMatrix.TransformFVector4(FVector4(
+                            ScreenX * GNearClippingPlane, ScreenY * GNearClippingPlane, 0.0f, GNearClippingPlane
+                        ))))
+                        .GetSafeNormal();
+    } else {
+        Origin =
+            InvViewMatrix.TransformFVector4(InvProjMatrix.TransformFVector4(FVector4(ScreenX, ScreenY, 0.5f, 1.0f)));
+        Direction = InvViewMatrix.TransformVector(FVector(0, 0, 1)).GetSafeNormal();
+    }
+
+    // fudge factor so we don't hit actor...
+    Origin += 1.0 * Direction;
+
+    InputState.Mouse.Position2D = ViewportMousePos;
+    InputState.Mouse.Delta2D = CurrentMouseState.Mouse.Position2D - PrevMousePosition;
+    PrevMousePosition = InputState.Mouse.Position2D;
+    InputState.Mouse.WorldRay = FRay(Origin, Direction);
+
+    // if we are in camera control we don't send any events
+    bool bInCameraControl = (ContextActor->GetCurrentInteractionMode() != EToolActorInteractionMode::NoInteraction);
+    if (bInCameraControl) {
+        ensure(bPendingMouseStateChange == false);
+        ensure(ToolsContext->InputRouter->HasActiveMouseCapture() == false);
+        // ToolsContext->InputRouter->PostHoverInputEvent(InputState);
+    } else if (bPendingMouseStateChange || ToolsContext->InputRouter->HasActiveMouseCapture()) {
+        ToolsContext->InputRouter->PostInputEvent(InputState);
+    } else {
+        const double CurrentTime = FPlatformTime::Seconds();
+        if (MaxHoverUpdateRate <= 0.0f || CurrentTime - LastHoverEventTime >= 1.0 / MaxHoverUpdateRate) {
             ToolsContext->InputRouter->PostHoverInputEvent(InputState);
+            LastHoverEventTime = CurrentTime;
+        } else {
+            // throttled, so make sure that the hover for the current mouse position is sent by a later tick
+            bTickStateDirty = true;
         }
+    }
 
-        // clear down or up flags now that we have sent event
-        if (bPendingMouseStateChange) {
-            if (CurrentMouseState.Mouse.Left.bDown) {
-                CurrentMouseState.Mouse.Left.SetStates(false, true, false);
-            } else {
-                CurrentMouseState.Mouse.Left.SetStates(false, false, false);
-            }
-            bPendingMouseStateChange = false;
+    // clear down or up flags now that we have sent event
+    if (bPendingMouseStateChange) {
+        if (CurrentMouseState.Mouse.Left.bDown) {
+            CurrentMouseState.Mouse.Left.SetStates(false, true, false);
+        } else {
+            CurrentMouseState.Mouse.Left.SetStates(false, false, false);
         }
+        bPendingMouseStateChange = false;
+    }
+}
 
 
-        // tick things
-        ToolsContext->ToolManager->Tick(DeltaTime);
-        ToolsContext->GizmoManager->Tick(DeltaTime);
+const FSceneView* UToolsSubsystem::UpdateCachedSceneView(
+    UGameViewportClient* ViewportClient, const FTickInputState& InputState
+) {
+    FViewport* Viewport = ViewportClient->Viewport;
+    const bool bIsOrtho = ViewportClient->IsOrtho();
+    ULocalPlayer* LocalPlayer = InputState.LocalPlayer.Get();
+    APlayerCameraManager* CameraManager = LocalPlayer->PlayerController->PlayerCameraManager;
+    const float FOVAngle = CameraManager ? CameraManager->GetFOVAngle() : 0.0f;
+
+    if (CachedView.SceneView != nullptr && CachedView.Viewport == Viewport && CachedView.LocalPlayer == LocalPlayer &&
+        CachedView.bIsOrtho == bIsOrtho && CachedView.FOVAngle == FOVAngle &&
+        CachedView.ViewLocation == InputState.ViewLocation && CachedView.ViewRotation == InputState.ViewRotation &&
+        CachedView.ViewportSize == InputState.ViewportSize) {
+        return CachedView.SceneView;
+    }
 
-        // render things
-        FRuntimeToolsFrameworkRenderImpl RenderAPI(PDIRenderComponent, SceneView, CurrentViewCameraState);
-        ToolsContext->ToolManager->Render(&RenderAPI);
-        ToolsContext->GizmoManager->Render(&RenderAPI);
+    // the old view is owned by the old family
+    CachedView.SceneView = nullptr;
+    CachedView.ViewFamily.Reset();
+
+    FEngineShowFlags* ShowFlags = ViewportClient->GetEngineShowFlags();
+    CachedView.ViewFamily = MakeUnique<FSceneViewFamilyContext>(
+        FSceneViewFamily::ConstructionValues(Viewport, TargetWorld->Scene, *ShowFlags).SetRealtimeUpdate(true)
+    );
+
+    FVector ViewLocation;
+    FRotator ViewRotation;
+    FSceneView* SceneView = LocalPlayer->CalcSceneView(
+        CachedView.ViewFamily.Get(), /*out*/ ViewLocation, /*out*/ ViewRotation, LocalPlayer->ViewportClient->Viewport
+    );
+    if (SceneView == nullptr) {
+        CachedView.ViewFamily.Reset();
+        return nullptr;
+    }
+
+    CachedView.SceneView = SceneView;
+    CachedView.Viewport = Viewport;
+    CachedView.LocalPlayer = LocalPlayer;
+    CachedView.bIsOrtho = bIsOrtho;
+    CachedView.FOVAngle = FOVAngle;
+    CachedView.ViewLocation = InputState.ViewLocation;
+    CachedView.ViewRotation = InputState.ViewRotation;
+    CachedView.ViewportSize = InputState.ViewportSize;
+    CachedView.InvViewMatrix = SceneView->ViewMatrices.GetInvViewMatrix();
+    CachedView.InvProjectionMatrix = SceneView->ViewMatrices.GetInvProjectionMatrix();
+    CachedView.ViewOrigin = SceneView->ViewMatrices.GetViewOrigin();
+
+    UGizmoViewContext* GizmoViewContext = ToolsContext->ContextObjectStore->FindContext<UGizmoViewContext>();
+    if (GizmoViewContext) {
+        GizmoViewContext->ResetFromSceneView(*SceneView);
+    }
+
+    CurrentViewCameraState.Position = ViewLocation;
+    CurrentViewCameraState.Orientation = ViewRotation.Quaternion();
+    CurrentViewCameraState.HorizontalFOVDegrees = SceneView->FOV;
+    CurrentViewCameraState.AspectRatio = Viewport->GetDesiredAspectRatio();  // ViewportClient->AspectRatio;
+    CurrentViewCameraState.bIsOrthographic = false;
+    CurrentViewCameraState.bIsVR = false;
+    CurrentViewCameraState.OrthoWorldCoordinateWidth = 1;
+
+    return SceneView;
+}
 
-        // force rendering flush so that PDI lines get drawn
-        FlushRenderingCommands();
+
+ULocalPlayer* UToolsSubsystem::FindInputLocalPlayer(
+    UGameViewportClient* ViewportClient, const FVector2D& ViewportMousePos
+) const {
+    ULocalPlayer* ContextPlayer = Cast<ULocalPlayer>(ContextActor->PlayerController->Player);
+    UGameInstance* GameInstance = TargetWorld->GetGameInstance();
+    if (GameInstance == nullptr || GameInstance->GetNumLocalPlayers() <= 1) {
+        return ContextPlayer;
+    }
+
+    // Origin/Size are the normalized split-screen area of each player
+    const FVector2D ViewportSize(ViewportClient->Viewport->GetSizeXY());
+    for (ULocalPlayer* LocalPlayer : GameInstance->GetLocalPlayers()) {
+        if (LocalPlayer == nullptr || LocalPlayer->PlayerController == nullptr) {
+            continue;
+        }
+        const FVector2D Min = LocalPlayer->Origin * ViewportSize;
+        const FVector2D Max = Min + LocalPlayer->Size * ViewportSize;
+        if (ViewportMousePos.X >= Min.X && ViewportMousePos.X < Max.X && ViewportMousePos.Y >= Min.Y &&
+            ViewportMousePos.Y < Max.Y) {
+            return LocalPlayer;
+        }
     }
+    return ContextPlayer;
 }
-UE_ENABLE_OPTIMIZATION
+
+
+bool UToolsSubsystem::CanSkipIdleTick(const FTickInputState& InputState) const {
+    return bEnableIdleTick && bTickStateDirty == false && bPendingMouseStateChange == false &&
+           ToolsContext->ToolManager->HasActiveTool(EToolSide::Mouse) == false && IsCapturingMouse() == false &&
+           InputState == LastTickInputState;
+}
+
 
 void UToolsSubsystem::SetContextActor(AToolsContextActor* ActorIn) {
     ContextActor = ActorIn;
+    bTickStateDirty = true;
     if (ContextQueriesAPI) {
         ContextQueriesAPI->SetContextActor(ContextActor);
     }
@@ -473,6 +678,28 @@ IToolsContextTransactionsAPI* UToolsSubsystem::GetTransactionsAPI() {
 }
 
 
+void UToolsSubsystem::RegisterMeshComponent(UDynamicMeshComponent* Component) {
+    if (CollisionUpdater) {
+        CollisionUpdater->AddComponent(Component);
+    }
+    if (RenderChunkUpdater) {
+        RenderChunkUpdater->AddComponent(Component);
+    }
+}
+
+void UToolsSubsystem::ReleaseMeshComponent(UDynamicMeshComponent* Component) {
+    if (TargetFactory) {
+        TargetFactory->ReleaseComponent(Component);
+    }
+    if (CollisionUpdater) {
+        CollisionUpdater->RemoveComponent(Component);
+    }
+    if (RenderChunkUpdater) {
+        RenderChunkUpdater->RemoveComponent(Component);
+    }
+}
+
+
 
 void UToolsSubsystem::OnLeftMouseDown() {
     CurrentMouseState.Mouse.Left.SetStates(true, false, false);
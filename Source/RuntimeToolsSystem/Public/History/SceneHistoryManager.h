@@ -90,6 +90,9 @@ public:
     DECLARE_MULTICAST_DELEGATE(FSceneHistoryStateChangeEvent);
     FSceneHistoryStateChangeEvent OnHistoryStateChange;
 
+    /** If false, appended Changes and Undo()/Redo() steps are not written to the log (e.g. while timing the history) */
+    bool bLogChanges = true;
+
 protected:
     // undo history, stored as a set of transactions, which are themselves list of (UObject,FCommandChange) pairs
     UPROPERTY()
@@ -69,6 +69,10 @@ public:
         FVector& TriBaryCoords, float MaxDistance = 0
     );
 
+    // Update the SourceMesh after the given triangles of the component mesh Mesh were edited. If the topology did not
+    // change, only the vertices of Triangles are copied. The AABB tree is rebuilt on the next spatial query.
+    void UpdateSourceMeshRegion(const FDynamicMesh3& Mesh, TArrayView<const int32> Triangles, bool bTopologyChanged);
+
     // USceneObject's representation in UE Level is a AActor
     UPROPERTY()
     AActor* Actor = nullptr;
@@ -77,6 +81,12 @@ protected:
     TUniquePtr<FDynamicMesh3> SourceMesh;
     TUniquePtr<FDynamicMeshAABBTree3> MeshAABBTree;
 
+    // set when SourceMesh was edited since the last MeshAABBTree build
+    bool bMeshAABBTreeDirty = false;
+
+    // @return MeshAABBTree, rebuilt first if it is dirty
+    FDynamicMeshAABBTree3& GetMeshAABBTree();
+
     void UpdateSourceMesh(const FMeshDescription* MeshDescription);
 
     TArray<UMaterialInterface*> Materials;
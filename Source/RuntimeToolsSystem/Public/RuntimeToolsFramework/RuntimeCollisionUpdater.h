@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "RuntimeCollisionUpdater.generated.h"
+
+class UDynamicMeshComponent;
+
+/**
+ * URuntimeCollisionUpdater takes collision rebuilds of edited UDynamicMeshComponents off the commit path.
+ * The UToolsSubsystem owns a single instance, and the tool target factory adds every Component it builds a target for.
+ *
+ * If bDeferCollisionUpdates is enabled, the Components' own collision updates are deferred, and any change of their
+ * mesh (commits, undo/redo) only marks the collision dirty. Tick() rebuilds it once the mesh has not changed for
+ * CollisionUpdateDelay seconds, so a burst of commits only cooks once, and with bUseAsyncCooking the cook runs on a
+ * worker thread and the new body setup is swapped in by the Component when it is done.
+ *
+ * Components are managed either way: if bDeferCollisionUpdates is off, they rebuild their collision on mesh change
+ * events themselves, and MarkCollisionDirty() (for edits without events) rebuilds it right away. Changing
+ * bDeferCollisionUpdates applies to all managed Components on the next Tick().
+ */
+UCLASS()
+class RUNTIMETOOLSSYSTEM_API URuntimeCollisionUpdater : public UObject {
+    GENERATED_BODY()
+public:
+    // defer collision rebuilds to Tick(). If false, Components rebuild their collision on every change, as before.
+    UPROPERTY(BlueprintReadWrite)
+    bool bDeferCollisionUpdates = true;
+
+    // cook collision on a worker thread
+    UPROPERTY(BlueprintReadWrite)
+    bool bUseAsyncCooking = true;
+
+    // time without further changes after which dirty collision is rebuilt, in seconds
+    UPROPERTY(BlueprintReadWrite)
+    float CollisionUpdateDelay = 0.25f;
+
+    // start managing the collision updates of the given Component. Does nothing if it is already managed.
+    void AddComponent(UDynamicMeshComponent* Component);
+
+    // stop managing the given Component, and hand its collision updates back to it. Dirty collision is rebuilt first.
+    void RemoveComponent(UDynamicMeshComponent* Component);
+
+    // mark the collision of the given Component dirty, for edits that did not emit mesh change events. Rebuilds it
+    // right away if bDeferCollisionUpdates is off.
+    void MarkCollisionDirty(UDynamicMeshComponent* Component);
+
+    // rebuild the collision of all dirty Components now, regardless of CollisionUpdateDelay
+    void FlushCollisionUpdates();
+
+    // rebuild dirty collision whose delay has expired. Called once per frame by the UToolsSubsystem.
+    void Tick();
+
+protected:
+    struct FComponentEntry {
+        TWeakObjectPtr<UDynamicMeshComponent> Component;
+        FDelegateHandle MeshChangedHandle;
+        // bDeferCollisionUpdates as last applied to the Component
+        bool bDeferred = false;
+        bool bDirty = false;
+        double LastChangeTime = 0.0;
+    };
+
+    TArray<FComponentEntry> Components;
+
+    FComponentEntry* FindEntry(UDynamicMeshComponent* Component);
+    void ApplyDeferral(FComponentEntry& Entry);
+    void UpdateCollision(FComponentEntry& Entry);
+};
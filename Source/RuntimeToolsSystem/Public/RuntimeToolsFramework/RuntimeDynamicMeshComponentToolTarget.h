@@ -8,9 +8,127 @@
 #include "TargetInterfaces/DynamicMeshSource.h"
 #include "TargetInterfaces/PhysicsDataSource.h"
 #include "ToolTargets/PrimitiveComponentToolTarget.h"
+#include "InteractiveToolChange.h"
+#include "MeshDescription.h"
+#include "DynamicMesh/DynamicMesh3.h"
+#include "DynamicMesh/DynamicMeshChangeTracker.h"
+#include "UObject/ObjectKey.h"
 #include "RuntimeDynamicMeshComponentToolTarget.generated.h"
 
 class UDynamicMesh;
+class UDynamicMeshComponent;
+
+
+/**
+ * FRuntimeMeshDescriptionCache caches the FMeshDescription conversion of UDynamicMeshes across tool targets and tool
+ * sessions. Each mesh has a change stamp that is incremented by its OnMeshChanged() event, and a cached conversion is
+ * re-used as long as the stamp has not changed. Read-only FDynamicMesh3 snapshots are cached the same way.
+ * Game thread only (the returned snapshots/conversions are immutable, and can be used on any thread).
+ */
+class RUNTIMETOOLSSYSTEM_API FRuntimeMeshDescriptionCache {
+public:
+    ~FRuntimeMeshDescriptionCache();
+
+    // @return the conversion of the current state of Mesh, which is only recomputed if Mesh changed since it was cached
+    TSharedPtr<const FMeshDescription> GetMeshDescription(UDynamicMesh* Mesh);
+
+    // @return an immutable copy of the current state of Mesh, which is only copied again if Mesh changed
+    TSharedPtr<const UE::Geometry::FDynamicMesh3, ESPMode::ThreadSafe> GetMeshSnapshot(UDynamicMesh* Mesh);
+
+    // @return the number of changes of Mesh seen since it was first added to the cache
+    uint64 GetChangeStamp(UDynamicMesh* Mesh) const;
+
+    // drop the cached conversion and snapshot of Mesh and advance its change stamp, for edits that were done without
+    // change events
+    void Invalidate(UDynamicMesh* Mesh);
+
+    // forget Mesh, including its change stamp, and stop listening to its change events
+    void Remove(UDynamicMesh* Mesh);
+
+    // scratch MeshDescription for committers to write into, kept between commits so that it keeps its allocations
+    FMeshDescription& GetCommitBuffer() {
+        return CommitBuffer;
+    }
+
+    // maximum number of meshes whose conversion/snapshot is kept. The least recently used ones are dropped first.
+    int32 MaxCachedMeshes = 16;
+
+protected:
+    struct FEntry {
+        TWeakObjectPtr<UDynamicMesh> Mesh;
+        FDelegateHandle MeshChangedHandle;
+        uint64 ChangeStamp = 0;
+
+        // conversion of the mesh at CachedChangeStamp, if valid
+        TSharedPtr<const FMeshDescription> MeshDescription;
+        uint64 CachedChangeStamp = 0;
+
+        // copy of the mesh at SnapshotChangeStamp, if valid
+        TSharedPtr<const UE::Geometry::FDynamicMesh3, ESPMode::ThreadSafe> Snapshot;
+        uint64 SnapshotChangeStamp = 0;
+
+        uint64 LastUsed = 0;
+    };
+    TMap<FObjectKey, FEntry> Entries;
+    uint64 UseCounter = 0;
+
+    FMeshDescription CommitBuffer;
+
+    FEntry& FindOrAddEntry(UDynamicMesh* Mesh);
+
+    // remove entries of destroyed meshes, and drop the least recently used conversions/snapshots over MaxCachedMeshes
+    void Trim();
+};
+
+
+/**
+ * FDynamicMeshSwapChange is a whole-mesh change of a UDynamicMeshComponent that does not keep a copy of either mesh.
+ * It holds whichever mesh is currently not in the UDynamicMesh (the old one after Apply(), the new one after Revert())
+ * and swaps it with the UDynamicMesh contents. This relies on the linear undo history, which guarantees that the
+ * UDynamicMesh is in the opposite state whenever the change is applied or reverted.
+ */
+class RUNTIMETOOLSSYSTEM_API FDynamicMeshSwapChange : public FToolCommandChange {
+public:
+    // OtherMeshIn is the mesh that the UDynamicMesh contained before the change was done
+    explicit FDynamicMeshSwapChange(TUniquePtr<UE::Geometry::FDynamicMesh3> OtherMeshIn) :
+        OtherMesh(MoveTemp(OtherMeshIn)) {}
+
+    virtual void Apply(UObject* Object) override;
+    virtual void Revert(UObject* Object) override;
+    virtual FString ToString() const override {
+        return TEXT("FDynamicMeshSwapChange");
+    }
+
+protected:
+    TUniquePtr<UE::Geometry::FDynamicMesh3> OtherMesh;
+
+    void SwapMeshes(UObject* Object);
+};
+
+
+/**
+ * FDynamicMeshRegionChange is a change of a region of a UDynamicMeshComponent mesh, recorded with a
+ * FDynamicMeshChangeTracker by URuntimeDynamicMeshComponentToolTarget::CommitMeshRegion(). Like that commit, undo/redo
+ * only update the render buffers of the changed triangles if the topology did not change.
+ */
+class RUNTIMETOOLSSYSTEM_API FDynamicMeshRegionChange : public FToolCommandChange {
+public:
+    TUniquePtr<UE::Geometry::FDynamicMeshChange> MeshChange;
+
+    // triangles whose vertices were changed, if !bTopologyChanged
+    TArray<int32> Triangles;
+    bool bTopologyChanged = false;
+
+    // conversion cache of the target that made the change, which has to be told about the edit
+    TWeakPtr<FRuntimeMeshDescriptionCache> MeshDescriptionCache;
+
+    virtual void Apply(UObject* Object) override;
+    virtual void Revert(UObject* Object) override;
+    virtual FString ToString() const override {
+        return TEXT("FDynamicMeshRegionChange");
+    }
+};
+
 
 /**
  * URuntimeDynamicMeshComponentToolTarget is a UToolTarget implementation suitable for
@@ -44,20 +162,47 @@ public:
         override;
     virtual FMeshDescription GetEmptyMeshDescription() override;
 
-    // IMeshDescriptionCommitter
+    // @return an empty FMeshDescription with the FStaticMeshAttributes registered
+    static FMeshDescription MakeEmptyMeshDescription();
+
+    // IMeshDescriptionCommitter. Unlike the engine targets, the Committer gets an empty FMeshDescription (with the
+    // FStaticMeshAttributes registered, re-using the allocations of earlier commits) and has to write the whole mesh,
+    // as the UE::ToolTarget commit functions do. This avoids converting and copying the current mesh just to have it
+    // overwritten. Committers that modify the current mesh have to use CommitMeshDescriptionEdit() instead.
     virtual void CommitMeshDescription(
         const FCommitter& Committer, const FCommitMeshParameters& CommitMeshParams = FCommitMeshParameters()
     ) override;
     using IMeshDescriptionCommitter::CommitMeshDescription;
 
-    // IDynamicMeshProvider
+    // like CommitMeshDescription(), but the Committer gets a copy of the current conversion to modify
+    void CommitMeshDescriptionEdit(const FCommitter& Committer);
+
+    // IDynamicMeshProvider. Returns a full copy, see ProcessReadOnlyMesh()/GetMeshSnapshot() for read-only access.
     virtual UE::Geometry::FDynamicMesh3 GetDynamicMesh() override;
 
+    // call ProcessFunc with the current mesh, without copying it. The mesh must not be kept beyond the call.
+    void ProcessReadOnlyMesh(TFunctionRef<void(const UE::Geometry::FDynamicMesh3&)> ProcessFunc);
+
+    // @return an immutable snapshot of the current mesh, shared with all other targets/tools that ask for the same
+    // mesh state (so it is only copied once per mesh change). Can be kept, and read on other threads.
+    TSharedPtr<const UE::Geometry::FDynamicMesh3, ESPMode::ThreadSafe> GetMeshSnapshot();
+
     // IDynamicMeshCommitter
     virtual void CommitDynamicMesh(const UE::Geometry::FDynamicMesh3& Mesh, const FDynamicMeshCommitInfo& CommitInfo)
         override;
     using IDynamicMeshCommitter::CommitDynamicMesh;
 
+    /**
+     * Edit a region of the mesh with EditFunc, and emit an undoable change that only stores that region.
+     * Triangles must contain every triangle that EditFunc modifies or removes, or that has a vertex moved by it
+     * (triangles added by EditFunc are tracked automatically). If bTopologyChanged is false, EditFunc may only move
+     * vertices, and only the render buffers and scene-object spatial data of Triangles are updated.
+     */
+    void CommitMeshRegion(
+        TArrayView<const int32> Triangles, TFunctionRef<void(UE::Geometry::FDynamicMesh3&)> EditFunc,
+        bool bTopologyChanged, const FText& ChangeMessage
+    );
+
     // IMaterialProvider
     virtual int32 GetNumMaterials() const override;
     virtual UMaterialInterface* GetMaterial(int32 MaterialIndex) const override;
@@ -76,11 +221,24 @@ public:
 
 protected:
     // In many cases it is necessary to convert the DynamicMeshComponent's UDynamicMesh/FDynamicMesh3 to a
-    // FMeshDescription. We cache this conversion in case it can be re-used.
-    TUniquePtr<FMeshDescription> CachedMeshDescription;
-    bool bHaveCachedMeshDescription = false;
+    // FMeshDescription. The conversion is cached in the (factory-owned) MeshDescriptionCache, so it can be re-used
+    // by later targets/tools, and the target holds on to the conversion it returned from GetMeshDescription().
+    TSharedPtr<FRuntimeMeshDescriptionCache> MeshDescriptionCache;
+    TSharedPtr<const FMeshDescription> CachedMeshDescription;
+    FRuntimeMeshDescriptionCache& GetMeshDescriptionCache();
     void InvalidateCachedMeshDescription();
 
+    // run Committer on the shared commit buffer, which is either emptied or set to the current conversion, and
+    // replace the mesh with the result
+    void CommitMeshDescriptionBuffer(const FCommitter& Committer, bool bCopyCurrentMesh);
+
+    // apply a region edit to the Component mesh and update the render buffers, Cache and owning USceneObject for it
+    static void ApplyRegionEdit(
+        UDynamicMeshComponent* Component, const TArray<int32>& Triangles, bool bTopologyChanged,
+        FRuntimeMeshDescriptionCache* Cache, TFunctionRef<void(UE::Geometry::FDynamicMesh3&)> EditFunc
+    );
+    friend class FDynamicMeshRegionChange;
+
 protected:
     friend class URuntimeDynamicMeshComponentToolTargetFactory;
 };
@@ -93,4 +251,20 @@ public:
     virtual bool CanBuildTarget(UObject* SourceObject, const FToolTargetTypeRequirements& TargetTypeInfo)
         const override;
     virtual UToolTarget* BuildTarget(UObject* SourceObject, const FToolTargetTypeRequirements& TargetTypeInfo) override;
+
+    // drop the cached target and the cached conversions/snapshot of Component, eg when its scene object is removed
+    // from the scene. The next BuildTarget() for it starts over.
+    void ReleaseComponent(UDynamicMeshComponent* Component);
+
+protected:
+    // shared by all targets built by this factory
+    TSharedPtr<FRuntimeMeshDescriptionCache> MeshDescriptionCache = MakeShared<FRuntimeMeshDescriptionCache>();
+
+    // Targets built so far, at most one per Component. BuildTarget() hands them out again for as long as their
+    // Component is valid and registered, so that their cached state survives across tool activations.
+    UPROPERTY()
+    TArray<URuntimeDynamicMeshComponentToolTarget*> CachedTargets;
+
+    // remove the targets of destroyed or unregistered Components
+    void PruneCachedTargets();
 };
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh/DynamicMesh3.h"
+
+struct FMeshDescription;
+
+/**
+ * FMeshDescription <-> FDynamicMesh3 conversions used by the RuntimeToolsSystem.
+ *
+ * Large meshes (see RuntimeTools.ParallelConversionThreshold) are converted with ParallelFor: vertex positions,
+ * per-triangle data and the attribute overlays (normals, tangents, UV layers, colors) are gathered/written in chunks,
+ * and only the element creation (which is not thread-safe in either mesh type) remains a serial loop over prepared
+ * arrays. The result matches the engine converters: overlay elements/vertex instances are welded per vertex and
+ * attribute value (or element), and edges along normal seams are hard. Everything the parallel path does not handle
+ * (non-compact meshes, non-manifold input) and small meshes go through the engine
+ * FMeshDescriptionToDynamicMesh/FDynamicMeshToMeshDescription converters.
+ */
+namespace RuntimeMeshConversion {
+
+// Convert MeshDescription to Mesh. Mesh is replaced, and has attributes enabled afterwards.
+RUNTIMETOOLSSYSTEM_API void MeshDescriptionToDynamicMesh(
+    const FMeshDescription& MeshDescription, UE::Geometry::FDynamicMesh3& Mesh, bool bCopyTangents = false
+);
+
+// Convert Mesh to MeshDescription, which must have the FStaticMeshAttributes registered. MeshDescription is replaced.
+RUNTIMETOOLSSYSTEM_API void DynamicMeshToMeshDescription(
+    const UE::Geometry::FDynamicMesh3& Mesh, FMeshDescription& MeshDescription, bool bCopyTangents = false
+);
+
+}  // namespace RuntimeMeshConversion
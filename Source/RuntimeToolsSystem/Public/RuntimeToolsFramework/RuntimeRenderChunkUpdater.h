@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "RuntimeRenderChunkUpdater.generated.h"
+
+class UDynamicMeshComponent;
+class UMaterialInterface;
+
+/**
+ * URuntimeRenderChunkUpdater splits the render buffers of edited UDynamicMeshComponents into spatial chunks (of at
+ * most RuntimeTools.RenderChunkSize triangles), so that FastNotifyTriangleVerticesUpdated() after a region edit only
+ * rebuilds the chunks that contain the edited triangles, instead of the vertex buffers of the whole mesh.
+ * The UToolsSubsystem owns a single instance, and the tool target factory adds every Component it builds a target for.
+ *
+ * The chunks are an external FMeshRenderDecomposition of the Component, which refers to triangle IDs and bakes in the
+ * Component materials. So it is rebuilt on every mesh change event that may change the topology (commits, undo/redo),
+ * before the Component re-creates its render proxy at the end of the frame. Tick() compares the Component materials
+ * with the ones the chunks were built with, so material changes (eg selection highlights) are picked up by the next
+ * Tick() without the code that sets them knowing about the chunks. A change made after the Tick() of a frame renders
+ * with the previous chunk materials for that one frame.
+ *
+ * Sculpting does not go through here: the UOctreeDynamicMeshComponent of the sculpt tools already splits its render
+ * buffers by octree cells, and only rebuilds the cells of the triangles that a stamp reinserted.
+ */
+UCLASS()
+class RUNTIMETOOLSSYSTEM_API URuntimeRenderChunkUpdater : public UObject {
+    GENERATED_BODY()
+public:
+    // start managing the render chunks of the given Component, and build them. Does nothing if it is already managed.
+    void AddComponent(UDynamicMeshComponent* Component);
+
+    // stop managing the given Component. Its current chunks stay in place (they match its mesh until it changes
+    // again), so it has to be added again before its mesh or materials are changed.
+    void RemoveComponent(UDynamicMeshComponent* Component);
+
+    // forget Components that have been destroyed, and rebuild the chunks of Components whose materials are not the
+    // ones they were built with. Called once per frame by the UToolsSubsystem.
+    void Tick();
+
+protected:
+    struct FComponentEntry {
+        TWeakObjectPtr<UDynamicMeshComponent> Component;
+        FDelegateHandle MeshChangedHandle;
+        // Component materials the chunks were built with
+        TArray<UMaterialInterface*> Materials;
+    };
+
+    TArray<FComponentEntry> Components;
+
+    FComponentEntry* FindEntry(UDynamicMeshComponent* Component);
+    bool HaveMaterialsChanged(const FComponentEntry& Entry) const;
+    void RebuildChunks(FComponentEntry& Entry);
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "RuntimeToolComputeScheduler.generated.h"
+
+class UInteractiveTool;
+class UMeshOpPreviewWithBackgroundCompute;
+
+/**
+ * URuntimeToolComputeScheduler coordinates the background computations of the runtime Tools
+ * (ie their UMeshOpPreviewWithBackgroundCompute previews). The UToolsSubsystem owns a single instance.
+ *
+ * Tools register their Preview with RegisterCompute(), and call RequestRecompute() instead of
+ * Preview->InvalidateResult(). Requests are coalesced and started in Tick(), once per frame:
+ *   - a new request for a compute that is still running cancels and restarts it (the old result is stale anyway)
+ *   - otherwise at most MaxConcurrentComputes are started, the active Tool first, then oldest request first
+ * (only one Tool is active at a time, and the current Tools register a single compute each, so the cap does not limit
+ * anything yet. It applies once a Tool registers several computes.)
+ *
+ * Tools tick their Preview, which is where finished results are applied, through TickCompute(). Applying results is
+ * limited to ResultBudgetMs of game-thread time per frame on average: time spent beyond the budget is carried over as
+ * debt, and computes with a result pending are not ticked while there is debt. So a result that takes longer than the
+ * budget to apply delays the next one by as many frames as it overran, rather than every frame taking as long.
+ */
+UCLASS()
+class RUNTIMETOOLSSYSTEM_API URuntimeToolComputeScheduler : public UObject {
+    GENERATED_BODY()
+public:
+    // maximum number of Tool background computations that may run at the same time
+    UPROPERTY(BlueprintReadWrite)
+    int32 MaxConcurrentComputes = 1;
+
+    // average game-thread time per frame that may be spent applying results to Tool previews, in milliseconds
+    UPROPERTY(BlueprintReadWrite)
+    float ResultBudgetMs = 4.0f;
+
+    // start tracking the background compute of the given Preview. @return ID to pass to the other functions
+    int32 RegisterCompute(UInteractiveTool* Tool, UMeshOpPreviewWithBackgroundCompute* Preview);
+
+    // stop tracking the given compute, pending requests are dropped
+    void UnregisterCompute(int32 ComputeID);
+
+    // stop tracking all computes registered by the given Tool
+    void UnregisterTool(UInteractiveTool* Tool);
+
+    // request that the given compute be restarted, replaces Preview->InvalidateResult()
+    void RequestRecompute(int32 ComputeID);
+
+    // run TickFunc (which should tick the Preview, and nothing else), unless the compute has a result pending and the
+    // result budget is used up, in which case it is skipped for this frame
+    void TickCompute(int32 ComputeID, TFunctionRef<void()> TickFunc);
+
+    // start pending computes. Called once per frame by the UToolsSubsystem, before the Tools are ticked.
+    void Tick(UInteractiveTool* ActiveTool);
+
+protected:
+    struct FComputeEntry {
+        TWeakObjectPtr<UInteractiveTool> Tool;
+        TWeakObjectPtr<UMeshOpPreviewWithBackgroundCompute> Preview;
+        bool bPending = false;
+        bool bRunning = false;
+        uint64 RequestSerial = 0;
+    };
+
+    TMap<int32, FComputeEntry> Computes;
+    int32 NextComputeID = 0;
+    uint64 NextRequestSerial = 0;
+
+    // TickCompute() time of computes with a pending result that was not covered by the budget of past frames
+    double ResultDebtSeconds = 0.0;
+};
@@ -1,8 +1,15 @@
 #pragma once
 
 #include "DynamicMeshSculptTool.h"
+#include "Changes/MeshChange.h"
+#include "InteractiveToolChange.h"
+#include "DynamicMesh/DynamicMeshChangeTracker.h"
+#include "Tools/RuntimeSculptBrushKernels.h"
 #include "RuntimeDynamicMeshSculptTool.generated.h"
 
+class UOctreeDynamicMeshComponent;
+class URuntimeDynamicMeshSculptTool;
+
 UCLASS()
 class RUNTIMETOOLSSYSTEM_API URuntimeDynamicMeshSculptToolBuilder : public UDynamicMeshSculptToolBuilder {
     GENERATED_BODY()
@@ -30,16 +37,250 @@ public:
 
     UPROPERTY(BlueprintReadWrite)
     int SelectedBrushType;
+
+    // evaluate brush stamps on worker threads. The result is the same as single-threaded.
+    UPROPERTY(BlueprintReadWrite)
+    bool bParallelStamps = true;
+
+    // maximum number of tasks a stamp is split into. 0 uses one task per worker thread.
+    UPROPERTY(BlueprintReadWrite)
+    int MaxStampTasks = 0;
+
+    // minimum number of vertices per stamp task, so small stamps are not split into more tasks than they are worth
+    UPROPERTY(BlueprintReadWrite)
+    int MinStampTaskVertices = 2048;
+
+    // maximum number of vertices a single stamp moves (the ones closest to the brush center). 0 means no limit.
+    UPROPERTY(BlueprintReadWrite)
+    int MaxStampVertices = 0;
+
+    // milliseconds per frame spent remeshing the regions touched by strokes, if remeshing is enabled. Regions that do
+    // not fit in the budget are remeshed in later frames. 0 remeshes every stamp completely in the frame it is applied.
+    UPROPERTY(BlueprintReadWrite)
+    float RemeshTimeBudgetMs = 4.0f;
+
+    // edge length the regions touched by strokes are remeshed towards, if remeshing is enabled. Set to the average
+    // edge length of the mesh by Setup().
+    UPROPERTY(BlueprintReadWrite)
+    float RemeshTargetEdgeLength = 1.0f;
 };
 
 
+/**
+ * FRuntimeSculptStrokeChange is the undo record of a stroke made by URuntimeDynamicMeshSculptTool. It only stores the
+ * vertices the stroke moved, with one position each: the position on the other side of the change (ie the position
+ * before the stroke while the change is applied, and the stroke result while it is reverted). Apply() and Revert()
+ * both swap those with the current positions. Strokes that remesh store the topology delta in TopologyChange instead.
+ */
+class RUNTIMETOOLSSYSTEM_API FRuntimeSculptStrokeChange : public FToolCommandChange {
+public:
+    TArray<int32> Vertices;
+    TArray<FVector3d> Positions;
+
+    // change of the remeshed triangles, for strokes that changed the topology. Vertices/Positions are empty then.
+    // Shared with the list of applied topology changes of the tool.
+    TSharedPtr<const FMeshChange> TopologyChange;
+
+    // swap Positions with the current positions of Vertices in Mesh
+    void SwapPositions(UE::Geometry::FDynamicMesh3& Mesh);
+
+    virtual void Apply(UObject* Object) override;
+    virtual void Revert(UObject* Object) override;
+    virtual bool HasExpired(UObject* Object) const override;
+    virtual FString ToString() const override {
+        return TEXT("FRuntimeSculptStrokeChange");
+    }
+};
+
+
+/**
+ * FRuntimeSculptStamp is the brush state of a single stamp of URuntimeDynamicMeshSculptTool, in the local space of the
+ * sculpt mesh. It maps the brush to a RuntimeSculptBrushKernels kernel with the speed scaling and the vertex formulas
+ * of the UDynamicMeshSculptTool brushes. RuntimeTools.CompareSculptBrushes checks the results of the two tools against
+ * each other.
+ */
+struct RUNTIMETOOLSSYSTEM_API FRuntimeSculptStamp {
+    ERuntimeDynamicMeshSculptBrushType BrushType = ERuntimeDynamicMeshSculptBrushType::Sculpt;
+    FVector3d BrushPos = FVector3d::Zero();
+    double Radius = 1.0;
+    double FalloffAmount = 0.5;
+    bool bInvert = false;
+
+    // SculptProperties->PrimaryBrushSpeed, SmoothBrushSpeed and bPreserveUVFlow
+    double PrimarySpeed = 1.0;
+    double SmoothSpeed = 1.0;
+    bool bPreserveUVFlow = false;
+
+    // normal of the hit triangle (Sculpt), brush movement since the last stamp (Move), and stroke plane (Flatten)
+    FVector3d BrushNormal = FVector3d::UnitZ();
+    FVector3d MoveDelta = FVector3d::Zero();
+    UE::Geometry::FFrame3d StrokePlane;
+
+    RuntimeSculptBrushKernels::FStampKernel MakeKernel() const;
+
+    // @return the vertex vector of VertexID for kernels with EDirection::PerVertex or ToTarget: the vertex normal
+    // (Inflate), or the uniform or mean-value (if bPreserveUVFlow) centroid of its neighbours (Smooth)
+    FVector3d GetVertexVector(const UE::Geometry::FDynamicMesh3& Mesh, int32 VertexID) const;
+};
+
+
+/**
+ * URuntimeDynamicMeshSculptTool applies the Move/Sculpt/Smooth/Inflate/Flatten brush stamps itself, instead of
+ * leaving them to the UDynamicMeshSculptTool. The stamp ROI (the vertices within the brush radius) is found with the
+ * octree of the sculpt Component, and split into contiguous ranges that are evaluated as separate tasks (see the
+ * RuntimeProperties thread controls), each with the vectorized kernels of RuntimeSculptBrushKernels. Every vertex
+ * only reads positions from before the stamp, and all positions are written afterwards, so the result does not depend
+ * on the number of tasks.
+ *
+ * The SculptComponent splits its render buffers by the cells of its octree, and after a stamp reinserts its triangles,
+ * only the modified cells are rebuilt. So the render update cost of a stamp depends on the brush size rather than on
+ * the size of the mesh.
+ *
+ * If remeshing is enabled, the region of each stamp is queued for remeshing (towards
+ * RuntimeProperties->RemeshTargetEdgeLength) rather than remeshed right away. OnTick() runs remesh passes over the
+ * queued regions until RuntimeProperties->RemeshTimeBudgetMs is used up, and leaves the rest for later frames (which
+ * can be after the stroke ended). Undo/redo reverts the remeshing that is still pending, and queues its regions again.
+ *
+ * Other brush types are still handled by the UDynamicMeshSculptTool.
+ *
+ * Strokes applied by this class are recorded as FRuntimeSculptStrokeChanges (remeshing that is still queued when a
+ * stroke ends is recorded as a separate change once it is done). If all strokes of the tool were, the accepted result
+ * is committed with CommitMeshRegion() for the region they changed, rather than by replacing the whole target mesh as
+ * the UDynamicMeshSculptTool does. Remeshed regions are committed by replaying their recorded topology changes.
+ */
 UCLASS(BlueprintType)
 class RUNTIMETOOLSSYSTEM_API URuntimeDynamicMeshSculptTool : public UDynamicMeshSculptTool {
     GENERATED_BODY()
 
 public:
     virtual void Setup() override;
+    virtual void Shutdown(EToolShutdownType ShutdownType) override;
+    virtual void OnTick(float DeltaTime) override;
+
+    virtual void OnBeginDrag(const FRay& Ray) override;
+    virtual void OnUpdateDrag(const FRay& Ray) override;
+    virtual void OnEndDrag(const FRay& Ray) override;
 
     UPROPERTY(BlueprintReadOnly)
     URuntimeDynamicMeshSculptToolProperties* RuntimeProperties;
-};
\ No newline at end of file
+
+    // mirrors SetEnableRemeshing(), which has no getter. Set by the ToolBuilder.
+    bool bRemeshingEnabled = false;
+
+    // if false, all strokes are left to the UDynamicMeshSculptTool (RuntimeTools.CompareSculptBrushes uses that to
+    // compare the two)
+    bool bApplyRuntimeStamps = true;
+
+protected:
+    // Component the UDynamicMeshSculptTool sculpts on
+    UPROPERTY()
+    UOctreeDynamicMeshComponent* SculptComponent = nullptr;
+
+    // true while a stroke is handled by this class rather than the UDynamicMeshSculptTool
+    bool bInStroke = false;
+
+    // stamps are applied once per tick, for the most recent drag ray
+    bool bStampPending = false;
+    FRay PendingStampRay;
+
+    // state of the active stroke, in the local space of the SculptComponent
+    ERuntimeDynamicMeshSculptBrushType StrokeBrushType = ERuntimeDynamicMeshSculptBrushType::Sculpt;
+    bool bInvertStroke = false;
+    UE::Geometry::FTransformSRT3d StrokeTransform;
+    UE::Geometry::FFrame3d StrokePlane;
+    FVector3d LastBrushPosLocal = FVector3d::Zero();
+
+    // brush falloff curve of the stamp kernels, if RuntimeTools.SculptFalloffTable is set. Rebuilt when the falloff
+    // changes.
+    RuntimeSculptBrushKernels::FFalloffTable FalloffTable;
+
+    // undo record of the active stroke, and markers of the vertices that are in it already
+    TUniquePtr<FRuntimeSculptStrokeChange> ActiveStrokeChange;
+    TBitArray<> StrokeVertexMarkers;
+
+    // vertices moved by strokes of this class without remeshing since Setup(). Along with AppliedTopologyChanges,
+    // this is all an accepted result has to commit unless bCommitTouchedVertices was cleared (by a stroke of the
+    // UDynamicMeshSculptTool).
+    TArray<int32> TouchedVertices;
+    TBitArray<> TouchedVertexMarkers;
+    bool bCommitTouchedVertices = true;
+
+    // topology changes of the sculpt mesh since Setup() that are currently applied, in the order they were applied
+    TArray<TSharedPtr<const FMeshChange>> AppliedTopologyChanges;
+
+    // ID ranges of the target mesh at Setup(), which the sculpt mesh was copied from with the same IDs
+    int32 SetupMaxVertexID = 0;
+    int32 SetupMaxTriangleID = 0;
+
+    // region of a stamp that still needs remesh passes
+    struct FRemeshRegion {
+        TArray<int32> Vertices;
+        int32 PassesLeft = 0;
+    };
+    TArray<FRemeshRegion> RemeshQueue;
+    TBitArray<> RemeshQueueVertexMarkers;
+
+    // records all topology changes while remeshing is enabled, from the start of a stroke until the end of the stroke
+    // (or, for remeshing that is still queued at the end, until the queue is empty)
+    TUniquePtr<UE::Geometry::FDynamicMeshChangeTracker> TopologyChangeTracker;
+
+    // per-stamp buffers, kept between stamps so that they keep their allocations
+    TArray<int32> RangeQueryTriangles;
+    TArray<int32> StampVertices;
+    TArray<FVector3d> StampPositions;
+    TArray<FVector3d> StampVertexVectors;
+    TArray<int32> StampTriangles;
+    TArray<int32> StampNormalElements;
+    TBitArray<> VertexMarkers;
+    TBitArray<> TriangleMarkers;
+    TBitArray<> ElementMarkers;
+
+    // apply a stamp of the active stroke for the given ray. @return false if the ray missed
+    bool ApplyStamp(const FRay& WorldRay);
+
+    // update the octree, normals and render buffers for the StampVertices after they moved
+    void UpdateStampVertices();
+
+    // recompute the normals of Triangles of Mesh after their vertices moved. The updated normal overlay elements (or
+    // vertices, if Mesh has per-vertex normals) are returned in Elements.
+    void UpdateNormals(UE::Geometry::FDynamicMesh3& Mesh, TArrayView<const int32> Triangles, TArray<int32>& Elements);
+
+    // emit the undo change of the active stroke, and end it
+    void EndStroke();
+
+    // queue the given vertices (the ones that exist) for remeshing, and remesh them right away if there is no time
+    // budget. Topology changes have to be recorded.
+    void QueueRemesh(TArrayView<const int32> Vertices);
+
+    // run remesh passes over the RemeshQueue until the queue is empty or the time budget is used up (at least one
+    // pass is run per call). A negative budget means no limit.
+    void ProcessRemeshQueue(double TimeBudgetSeconds);
+
+    // run a remesh pass over Region, and update its vertices to the remeshed region
+    void RemeshRegion(FRemeshRegion& Region);
+
+    // start recording topology changes, if not recording already
+    void BeginTopologyChange();
+
+    // emit the recorded topology changes as a FRuntimeSculptStrokeChange
+    void EmitTopologyChange(const FText& ChangeMessage);
+
+    // finish the RemeshQueue without time budget, and emit the topology changes recorded since the last stroke
+    void FinishPendingRemesh();
+
+    // drop the RemeshQueue, and revert the remeshing done since the last emitted change. The vertices of the regions
+    // that were queued or reverted are returned in RegionVertices, to queue them again.
+    void CancelPendingRemesh(TArray<int32>& RegionVertices);
+
+    // undo/redo a stroke of this tool. Remeshing that was pending is redone on the mesh after the change.
+    void ApplyStrokeChange(FRuntimeSculptStrokeChange& Change, bool bRevert);
+    friend class FRuntimeSculptStrokeChange;
+
+    // commit the AppliedTopologyChanges and TouchedVertices of the sculpt mesh to the target. @return false if the
+    // result has to be committed by the UDynamicMeshSculptTool instead
+    bool CommitTouchedVertices();
+
+    // split [0, Num) into contiguous ranges according to the RuntimeProperties thread controls, and call RangeFunc for
+    // each of them (on worker threads, if there is more than one)
+    void ParallelForStampRanges(int32 Num, TFunctionRef<void(int32 Start, int32 End)> RangeFunc) const;
+};
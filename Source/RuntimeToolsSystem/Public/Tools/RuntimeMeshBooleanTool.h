@@ -34,8 +34,14 @@ public:
 
     virtual void Shutdown(EToolShutdownType ShutdownType) override;
 
+    virtual void OnTick(float DeltaTime) override;
+
     UPROPERTY(BlueprintReadOnly)
     URuntimeMeshBooleanToolProperties* RuntimeProperties;
+
+protected:
+    // Preview recomputes go through the UToolsSubsystem compute scheduler
+    int32 ComputeID = INDEX_NONE;
 };
 
 
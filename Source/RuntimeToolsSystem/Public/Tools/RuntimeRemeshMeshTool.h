@@ -31,7 +31,13 @@ class RUNTIMETOOLSSYSTEM_API URuntimeRemeshMeshTool : public URemeshMeshTool {
 
 public:
     virtual void Setup() override;
+    virtual void Shutdown(EToolShutdownType ShutdownType) override;
+    virtual void OnTick(float DeltaTime) override;
 
     UPROPERTY(BlueprintReadOnly)
     URuntimeRemeshMeshToolProperties* RuntimeProperties;
+
+protected:
+    // Preview recomputes go through the UToolsSubsystem compute scheduler
+    int32 ComputeID = INDEX_NONE;
 };
\ No newline at end of file
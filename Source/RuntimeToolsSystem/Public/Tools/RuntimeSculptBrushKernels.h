@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VectorTypes.h"
+
+/**
+ * Falloff and displacement kernels of the URuntimeDynamicMeshSculptTool brushes.
+ *
+ * Every brush moves a vertex by Falloff * Speed along a direction, or that far towards a target position, where the
+ * falloff only depends on the distance to the brush center. By default the falloff is CalculateFalloff(), and the
+ * kernels evaluate it and the displacement with the same operations, in the same order, as the per-vertex code. The
+ * vectorized kernels do that for blocks of vertices in structure-of-arrays form with the engine VectorRegister4Double
+ * operations, which map to SSE/AVX/NEON or to a scalar fallback depending on the platform. They use no fused
+ * multiply-adds, so every lane rounds like the scalar code.
+ *
+ * Optionally the falloff curve is looked up in a FFalloffTable instead. The table is over the squared distance, so
+ * that no square root is needed, but it only approximates the curve, and the lookup itself is scalar (there is no
+ * gather on most platforms). RuntimeTools.BenchmarkSculptKernels times both modes and reports their deviation from
+ * the per-vertex evaluation.
+ */
+namespace RuntimeSculptBrushKernels {
+
+// falloff curve of the sculpt brushes: constant up to (1-Falloff)*Radius, then a smooth cubic to zero
+RUNTIMETOOLSSYSTEM_API double CalculateFalloff(double Distance, double Radius, double FalloffAmount);
+
+
+// CalculateFalloff() for a given falloff amount, tabulated over the squared normalized distance
+class RUNTIMETOOLSSYSTEM_API FFalloffTable {
+public:
+    static constexpr int32 NumIntervals = 1024;
+
+    // rebuild the table if it was built for a different FalloffAmount
+    void Update(double FalloffAmount);
+
+    // @return the linearly interpolated falloff for DistanceSqrNormalized = (Distance/Radius)^2
+    double Evaluate(double DistanceSqrNormalized) const {
+        const double T = FMathd::Clamp(DistanceSqrNormalized, 0.0, 1.0) * NumIntervals;
+        const int32 Index = FMath::Min(static_cast<int32>(T), NumIntervals - 1);
+        return FMathd::Lerp(Values[Index], Values[Index + 1], T - Index);
+    }
+
+protected:
+    TArray<double> Values;
+    double TableFalloffAmount = -1.0;
+};
+
+
+// displacement of a brush stamp, with Falloff = CalculateFalloff(Distance(Pos, BrushPos), Radius, FalloffAmount)
+struct FStampKernel {
+    enum class EDirection {
+        // NewPos = Pos + Falloff * Speed * Direction (Move, Sculpt)
+        Constant,
+        // NewPos = Pos + Falloff * Speed * the vertex vector passed to EvaluateStamp() (Inflate: vertex normals)
+        PerVertex,
+        // NewPos = Lerp(Pos, the vertex vector passed to EvaluateStamp(), Falloff * Speed) (Smooth: centroids)
+        ToTarget,
+        // NewPos = Lerp(Pos, Pos projected onto the plane through PlaneOrigin with normal Direction, Falloff * Speed)
+        // (Flatten)
+        ToPlane
+    };
+    EDirection DirectionType = EDirection::Constant;
+
+    FVector3d BrushPos = FVector3d::Zero();
+    double Radius = 1.0;
+    double Speed = 1.0;
+    FVector3d Direction = FVector3d::UnitZ();
+    FVector3d PlaneOrigin = FVector3d::Zero();
+
+    // BrushFalloffAmount, see CalculateFalloff()
+    double FalloffAmount = 0.5;
+};
+
+// Evaluate Kernel for Positions (and VertexVectors, for EDirection::PerVertex and ToTarget), and write the new
+// positions to Result (which may be Positions). The falloff is CalculateFalloff(), or looked up in FalloffTable if it
+// is not null (which must be up to date for Kernel.FalloffAmount). bVectorized=false evaluates the same kernel one
+// vertex at a time.
+RUNTIMETOOLSSYSTEM_API void EvaluateStamp(
+    const FStampKernel& Kernel, const FFalloffTable* FalloffTable, TArrayView<const FVector3d> Positions,
+    TArrayView<const FVector3d> VertexVectors, TArrayView<FVector3d> Result, bool bVectorized = true
+);
+
+}  // namespace RuntimeSculptBrushKernels
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/PrimitiveComponent.h"
+#include <atomic>
 #include "ToolsContextRenderComponent.generated.h"
 
 class FPrimitiveDrawInterface;
@@ -13,11 +14,29 @@ class FPrimitiveDrawInterface;
  * The UToolsContextRenderComponent will accumulate any DrawLine() and DrawPoint() requests
  * and then pass them to it's SceneProxy for rendering in the next frame.
  *
+ * Accumulated geometry is handed to the SceneProxy via frame-numbered buffers: DrawLine()/DrawPoint() append to a
+ * per-thread buffer without taking any locks, PublishFrame() gathers those into a complete frame and atomically swaps
+ * it into the published slot, and the SceneProxy picks up the latest published frame when it renders (and keeps
+ * drawing it until a newer one arrives). So no rendering flush is needed to get the lines on screen.
+ * The frames are recycled through a triple buffer, so in steady state the handoff does not allocate.
+ * Use DrawLines()/DrawPoints() to submit whole arrays of primitives with a single call.
+ *
  * (in the UE Editor, those functions can be passed an Editor PDI that can draw immediately,
  *  but this is not possible at Runtime, so we use this accumulate-and-draw workaround)
  *
- * TODO: lines and points could be drawn via Line/Point Components, which would allow them
- * to be batched, providing much better performance.
+ * The SceneProxy does not forward the primitives to the PDI one-by-one, but writes them into a few
+ * vertex-buffer batches, using the same materials as the ModelingComponents Line/Point Set Components.
+ * The batches are only rebuilt when a new frame is published, and are shared by all views (split-screen, multiple
+ * viewports, scene captures) that render it.
+ *
+ * Each published frame and retained layer carries the bounds of its geometry, and the SceneProxy culls it per view
+ * against those (and each batch against its own sub-bounds). So the overlay is neither rebuilt nor drawn when it is
+ * off-screen. The Component bounds follow the published frames and visible layers, padded by one frame of growth, as
+ * the SceneProxy can pick up a frame before the bounds that go with it.
+ *
+ * Overlays that rarely change (e.g. polygon-group borders) do not need to be re-submitted every frame. They can be
+ * put in a retained layer instead (see CreateOverlayLayer()), whose vertex buffers the SceneProxy keeps and only
+ * rebuilds when the layer geometry is replaced.
  */
 UCLASS()
 class RUNTIMETOOLSSYSTEM_API UToolsContextRenderComponent : public UPrimitiveComponent {
@@ -42,6 +61,56 @@ public:
         uint8 DepthPriorityGroup;
     };
 
+    // complete set of lines/points drawn during one game-thread frame
+    struct FGeometryFrame {
+        uint64 FrameNumber = 0;
+        TArray<FPDILine> Lines;
+        TArray<FPDIPoint> Points;
+
+        // world-space bounds of all line endpoints and points
+        FBox Bounds = FBox(ForceInit);
+    };
+
+    // geometry of a retained overlay layer. Immutable once set, and shared between the Component and the SceneProxy.
+    struct FOverlayLayerGeometry {
+        TArray<FPDILine> Lines;
+        TArray<FPDIPoint> Points;
+
+        // world-space bounds of all line endpoints and points
+        FBox Bounds = FBox(ForceInit);
+    };
+
+    // Lock-free triple buffer between PublishFrame() and the SceneProxy. The three frames are only allocated once
+    // and then recycled, so their arrays keep their capacity and the steady-state handoff does no heap allocation.
+    // Shared with the SceneProxy, so that it stays valid for whichever side is destroyed last.
+    struct FGeometryMailbox {
+        FGeometryFrame Frames[3];
+
+        // index of the most recently published frame, plus NewFrameFlag if the SceneProxy has not picked it up yet
+        static constexpr uint32 NewFrameFlag = 4;
+        std::atomic<uint32> PublishedFrame{1};
+
+        // frame being filled by PublishFrame(), only accessed on the game thread
+        uint32 WriteFrame = 0;
+
+        // frame being drawn by the SceneProxy, only accessed on the render thread
+        uint32 ReadFrame = 2;
+
+        // game thread: publish Frames[WriteFrame], and switch WriteFrame to a frame that is not in use anymore
+        void Publish() {
+            const uint32 Previous = PublishedFrame.exchange(WriteFrame | NewFrameFlag, std::memory_order_acq_rel);
+            WriteFrame = Previous & ~NewFrameFlag;
+        }
+
+        // render thread: @return the most recently published frame (which is kept until a newer one is published)
+        const FGeometryFrame& AcquireLatest() {
+            if (PublishedFrame.load(std::memory_order_acquire) & NewFrameFlag) {
+                ReadFrame = PublishedFrame.exchange(ReadFrame, std::memory_order_acq_rel) & ~NewFrameFlag;
+            }
+            return Frames[ReadFrame];
+        }
+    };
+
 public:
     /** @return a new FPrimitiveDrawInterface implementation allocated for the given FSceneView. See .cpp for details.
      */
@@ -58,23 +127,132 @@ public:
         const FVector& Position, const FLinearColor& Color, float PointSize, uint8 DepthPriorityGroup
     );
 
+    // append a whole array of lines with a single call
+    void DrawLines(TArrayView<const FPDILine> Lines);
+
+    // append a whole array of points with a single call
+    void DrawPoints(TArrayView<const FPDIPoint> Points);
+
+    // reserve space for NumLines additional lines in the calling thread's buffer
+    void ReserveLines(int32 NumLines);
+
+    // reserve space for NumPoints additional points in the calling thread's buffer
+    void ReservePoints(int32 NumPoints);
+
+    /**
+     * Publish the lines/points accumulated since the last call as a complete frame, which the SceneProxy will pick up
+     * the next time it renders. Call once per tick on the game thread, after all Render() calls (including any
+     * DrawLine()/DrawPoint() calls made from other threads) have completed.
+     */
+    void PublishFrame();
+
+
+    /**
+     * Create a retained overlay layer. Its lines/points are drawn every frame until the layer is destroyed, without
+     * having to be re-submitted, and the SceneProxy only rebuilds its render buffers when they are replaced.
+     * Game thread only, like the other layer functions.
+     * @return handle to the new layer
+     */
+    int32 CreateOverlayLayer();
+
+    // replace all lines of the given layer
+    void SetOverlayLayerLines(int32 LayerID, TArray<FPDILine> Lines);
+
+    // replace all points of the given layer
+    void SetOverlayLayerPoints(int32 LayerID, TArray<FPDIPoint> Points);
+
+    // replace all lines and points of the given layer
+    void SetOverlayLayerGeometry(int32 LayerID, TArray<FPDILine> Lines, TArray<FPDIPoint> Points);
+
+    // show/hide the given layer. Hidden layers keep their render buffers.
+    void SetOverlayLayerVisible(int32 LayerID, bool bVisible);
+
+    // destroy the given layer and release its render buffers
+    void DestroyOverlayLayer(int32 LayerID);
+
+    // @return true if LayerID refers to a layer that has not been destroyed yet
+    bool IsValidOverlayLayer(int32 LayerID) const;
+
+
+    // materials used to draw batched lines/points, depth-tested (SDPG_World) and overlaid (SDPG_Foreground).
+    // Default to the ModelingComponents line/point set materials.
+    UPROPERTY()
+    UMaterialInterface* LineMaterial;
+
+    UPROPERTY()
+    UMaterialInterface* OverlaidLineMaterial;
+
+    UPROPERTY()
+    UMaterialInterface* PointMaterial;
+
+    UPROPERTY()
+    UMaterialInterface* OverlaidPointMaterial;
 
 protected:
-    // set of lines populated by DrawLine calls
-    TArray<FPDILine> CurrentLines;
+    // lines/points appended by a single thread during the current frame
+    struct FThreadGeometryBuffer {
+        TArray<FPDILine> Lines;
+        TArray<FPDIPoint> Points;
+    };
+
+    // buffer for the game thread, which is where tools and gizmos Render(). Only accessed on the game thread.
+    FThreadGeometryBuffer GameThreadBuffer;
+
+    // buffers registered by other threads during the current frame
+    TArray<TUniquePtr<FThreadGeometryBuffer>> WorkerThreadBuffers;
 
-    // set of points created by DrawPoint calls
-    TArray<FPDIPoint> CurrentPoints;
+    // emptied worker-thread buffers from previous frames, reused so that they keep their capacity
+    TArray<TUniquePtr<FThreadGeometryBuffer>> FreeWorkerThreadBuffers;
 
-    // protects CurrentLines and CurrentPoints
-    FCriticalSection GeometryLock;
+    // protects (Free)WorkerThreadBuffers. Only taken the first time a non-game thread draws in a frame.
+    FCriticalSection WorkerThreadBuffersLock;
+
+    // globally-unique id of the current accumulation frame, used to validate the per-thread buffer caches
+    std::atomic<uint32> AccumulationEpoch{AllocateAccumulationEpoch()};
+    static uint32 AllocateAccumulationEpoch();
+
+    // @return the buffer the calling thread should append to
+    FThreadGeometryBuffer& GetThreadBuffer();
+
+    // game-thread state of a retained overlay layer
+    struct FOverlayLayer {
+        TSharedPtr<const FOverlayLayerGeometry, ESPMode::ThreadSafe> Geometry;
+        bool bVisible = true;
+    };
+
+    TMap<int32, FOverlayLayer> OverlayLayers;
+    int32 NextOverlayLayerID = 0;
+
+    // replace the geometry of the given layer and pass it on to the SceneProxy
+    void SetOverlayLayerGeometryInternal(
+        int32 LayerID, TSharedPtr<const FOverlayLayerGeometry, ESPMode::ThreadSafe> Geometry
+    );
+
+    // forward the current state of the given layer to the SceneProxy (which removes it if it does not exist anymore)
+    void SendOverlayLayerToProxy(int32 LayerID);
+
+    // bounds of the last published frame and the layers visible then, and the padded bounds returned by CalcBounds()
+    FBox LastContentBounds = FBox(ForceInit);
+    FBox PublishedBounds = FBox(ForceInit);
+
+    // accumulate the bounds of the new frame and the visible layers, and update the Component bounds if they changed
+    void UpdatePublishedBounds(const FBox& FrameBounds);
+
+    // published frames are handed to the SceneProxy through this
+    TSharedPtr<FGeometryMailbox, ESPMode::ThreadSafe> Mailbox = MakeShared<FGeometryMailbox, ESPMode::ThreadSafe>();
 
     // returns a lambda that will be passed to SceneProxy, which will then allow it to
-    // steal values of CurrentLines and CurrentPoints
-    TUniqueFunction<void(TArray<FPDILine>&, TArray<FPDIPoint>&)> MakeGetCurrentGeometryQueryFunc();
+    // acquire the latest published frame
+    TUniqueFunction<const FGeometryFrame&()> MakeGetCurrentGeometryQueryFunc();
+
+    //~ Begin UActorComponent Interface.
+    virtual void OnRegister() override;
+    //~ End UActorComponent Interface.
 
     //~ Begin UPrimitiveComponent Interface.
     virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+    virtual void GetUsedMaterials(TArray<UMaterialInterface*>& OutMaterials, bool bGetDebugMaterials = false)
+        const override;
     virtual bool LineTraceComponent(
         FHitResult& OutHit, const FVector Start, const FVector End, const FCollisionQueryParams& Params
     ) override;
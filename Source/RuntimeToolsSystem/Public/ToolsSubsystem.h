@@ -4,8 +4,12 @@
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "InteractiveToolsContext.h"
 #include "ToolsContextRenderComponent.h"
+#include "SceneView.h"
 #include "Interaction/SelectionManager.h"
 #include "Interaction/TransformManager.h"
+#include "RuntimeToolsFramework/RuntimeToolComputeScheduler.h"
+#include "RuntimeToolsFramework/RuntimeCollisionUpdater.h"
+#include "RuntimeToolsFramework/RuntimeRenderChunkUpdater.h"
 #include "ToolsSubsystem.generated.h"
 
 
@@ -13,6 +17,10 @@ class FRuntimeToolsContextQueriesImpl;
 class FRuntimeToolsContextTransactionImpl;
 class FRuntimeToolsContextAssetImpl;
 class AToolsContextActor;
+class UGameViewportClient;
+class UDynamicMeshComponent;
+class URuntimeDynamicMeshComponentToolTargetFactory;
+class ULocalPlayer;
 
 
 /**
@@ -30,6 +38,8 @@ class RUNTIMETOOLSSYSTEM_API UToolsSubsystem : public UGameInstanceSubsystem {
 public:
     static void InitializeSingleton(UToolsSubsystem* Subsystem);
     static UToolsSubsystem* Get();
+    // like Get(), but returns null rather than asserting if there is no subsystem (yet, or anymore)
+    static UToolsSubsystem* TryGet();
 
 protected:
     static UToolsSubsystem* InstanceSingleton;
@@ -49,6 +59,11 @@ public:
     void InitializeToolsContext(UWorld* TargetWorld);
     void ShutdownToolsContext();
     void SetContextActor(AToolsContextActor* ActorIn);
+
+    // Route input and Render() tools/gizmos once. With split-screen, the input goes to the view of the local player
+    // under the mouse (or the one that captured it). Render() only runs for that view: the PDI lines are in world
+    // space and so are drawn by all views that see them, but anything sized or culled for the view (eg gizmos with
+    // a constant screen size) is only correct in the input view.
     virtual void Tick(float DeltaTime);
 
 
@@ -65,6 +80,26 @@ public:
 
     TArray<UObject*> GetActiveToolPropertySets();
 
+    URuntimeToolComputeScheduler* GetComputeScheduler() {
+        return ComputeScheduler;
+    }
+
+    URuntimeCollisionUpdater* GetCollisionUpdater() {
+        return CollisionUpdater;
+    }
+
+    URuntimeRenderChunkUpdater* GetRenderChunkUpdater() {
+        return RenderChunkUpdater;
+    }
+
+    // hand the collision and render chunk updates of Component to the CollisionUpdater and RenderChunkUpdater. The
+    // tool target factory does this for every Component it builds a target for.
+    void RegisterMeshComponent(UDynamicMeshComponent* Component);
+
+    // drop the cached tool target, cached MeshDescription and updater registrations of Component, eg when its scene
+    // object is removed from the scene
+    void ReleaseMeshComponent(UDynamicMeshComponent* Component);
+
 
     //
     // Tool creation/management BP API
@@ -130,6 +165,20 @@ public:
     UFUNCTION(BlueprintCallable)
     bool IsCapturingMouse() const;
 
+    // If true, Tick() skips view/ray computation, hover routing and tool rendering on frames where no tool is
+    // active and the mouse, modifier keys, camera and scene have not changed since the last full tick.
+    UPROPERTY(BlueprintReadWrite)
+    bool bEnableIdleTick = true;
+
+    // Maximum number of hover events per second sent to the InputRouter. <= 0 sends one every tick.
+    UPROPERTY(BlueprintReadWrite)
+    float MaxHoverUpdateRate = 60.0f;
+
+    // force the next Tick() to do a full update, eg after modifying the scene outside of tools/history/selection
+    void InvalidateIdleTick() {
+        bTickStateDirty = true;
+    }
+
 protected:
     void OnLeftMouseDown();
     void OnLeftMouseUp();
@@ -160,6 +209,18 @@ public:
     UPROPERTY()
     USceneHistoryManager* SceneHistory;
 
+    UPROPERTY()
+    URuntimeToolComputeScheduler* ComputeScheduler;
+
+    UPROPERTY()
+    URuntimeCollisionUpdater* CollisionUpdater;
+
+    UPROPERTY()
+    URuntimeRenderChunkUpdater* RenderChunkUpdater;
+
+    UPROPERTY()
+    URuntimeDynamicMeshComponentToolTargetFactory* TargetFactory;
+
 
 protected:
     TSharedPtr<FRuntimeToolsContextQueriesImpl> ContextQueriesAPI;
@@ -173,6 +234,8 @@ protected:
 
     void OnSceneHistoryStateChange();
 
+    FDelegateHandle SelectionChangedEventHandle;
+
 
     // mouse things
 
@@ -186,6 +249,77 @@ protected:
     FViewCameraState CurrentViewCameraState;
 
 
+    // idle tick tracking
+
+    // the inputs that determine the result of a tick when no tool is active
+    struct FTickInputState {
+        TWeakObjectPtr<ULocalPlayer> LocalPlayer;
+        FVector2D MousePosition = FVector2D::ZeroVector;
+        FVector ViewLocation = FVector::ZeroVector;
+        FRotator ViewRotation = FRotator::ZeroRotator;
+        FIntPoint ViewportSize = FIntPoint::ZeroValue;
+        bool bShiftDown = false;
+        bool bAltDown = false;
+        bool bControlDown = false;
+        bool bCommandDown = false;
+
+        bool operator==(const FTickInputState& Other) const {
+            return LocalPlayer == Other.LocalPlayer && MousePosition == Other.MousePosition &&
+                   ViewLocation == Other.ViewLocation && ViewRotation == Other.ViewRotation &&
+                   ViewportSize == Other.ViewportSize && bShiftDown == Other.bShiftDown && bAltDown == Other.bAltDown &&
+                   bControlDown == Other.bControlDown && bCommandDown == Other.bCommandDown;
+        }
+    };
+
+    // input state of the last full tick
+    FTickInputState LastTickInputState;
+
+    // set when something other than the FTickInputState changes (tools, history, selection), cleared by a full tick
+    bool bTickStateDirty = true;
+
+    // time of the last hover event sent to the InputRouter, for MaxHoverUpdateRate
+    double LastHoverEventTime = 0.0;
+
+    // @return true if this tick can be skipped, see bEnableIdleTick
+    bool CanSkipIdleTick(const FTickInputState& InputState) const;
+
+
+    // scene view cache
+
+    // SceneView (and the derived camera/projection state) from the last CalcSceneView(), reused until the
+    // input player, its viewpoint, FOV or viewport changes
+    struct FCachedSceneView {
+        TUniquePtr<FSceneViewFamilyContext> ViewFamily;
+        FSceneView* SceneView = nullptr;  // owned by ViewFamily
+
+        // cache key
+        FViewport* Viewport = nullptr;
+        const ULocalPlayer* LocalPlayer = nullptr;
+        FVector ViewLocation = FVector::ZeroVector;
+        FRotator ViewRotation = FRotator::ZeroRotator;
+        FIntPoint ViewportSize = FIntPoint::ZeroValue;
+        float FOVAngle = 0.0f;
+        bool bIsOrtho = false;
+
+        // used to construct the mouse ray
+        FMatrix InvViewMatrix = FMatrix::Identity;
+        FMatrix InvProjectionMatrix = FMatrix::Identity;
+        FVector ViewOrigin = FVector::ZeroVector;
+    };
+    FCachedSceneView CachedView;
+
+    // @return the local player whose split-screen view contains ViewportMousePos (the ContextActor's player if there
+    // is only one, or the mouse is outside all of them)
+    ULocalPlayer* FindInputLocalPlayer(UGameViewportClient* ViewportClient, const FVector2D& ViewportMousePos) const;
+
+    // compute the mouse ray for the given SceneView and send the mouse/hover event to the InputRouter
+    void RouteMouseInput(FInputDeviceState& InputState, const FVector2D& ViewportMousePos, const FSceneView* SceneView);
+
+    // Rebuild CachedView if the view has changed, which also updates the GizmoViewContext and CurrentViewCameraState.
+    // @return the cached SceneView, or null if it could not be computed
+    const FSceneView* UpdateCachedSceneView(UGameViewportClient* ViewportClient, const FTickInputState& InputState);
+
+
     // property set keepalive hack
 
     void AddPropertySetKeepalive(UInteractiveToolPropertySet* PropertySet);
@@ -23,6 +23,7 @@ public class RuntimeToolsSystem : ModuleRules {
 			"Slate",
 			"InputCore",
 			"RenderCore",
+			"RHI",
 			"GeometryCore",
 			"GeometryFramework",
 			"MeshDescription",